@@ -28,6 +28,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 #include "TApplication.h"
 #include "TArrayI.h"
@@ -54,8 +55,15 @@ class TRestDetectorGainMap : public TRestMetadata {
 
     void InitFromConfigFile() override;
 
-    void SaveToText(std::string filename) {}
-    void ReadGainText(std::string filename) {}
+    void FillChannelGainTable(std::vector<double>& table, double defaultGain = 1) const;
+
+    Bool_t SaveToText(std::string filename) const;
+    Bool_t ReadGainText(std::string filename);
+
+    Bool_t SaveToBinary(std::string filename) const;
+    Bool_t ReadGainBinary(std::string filename);
+
+    Bool_t ReadGainFile(std::string filename);
 
     void DrawChannelGainMap(TRestDetectorReadoutModule* mod = 0);
 
@@ -51,10 +51,15 @@ class TRestDetectorHitmapAnalysisProcess : public TRestEventProcess {
     /// A pointer to the specific TRestDetectorHitsEvent input
     TRestDetectorHitsEvent* fHitsEvent;  //!
 
+    /// The transformations in fTransformations, resolved by name at InitProcess
+    std::vector<HitTransformation> fTransformationSequence;  //!
+
     void InitFromConfigFile() override;
 
     void Initialize() override;
 
+    void InitProcess() override;
+
    protected:
     /// A list of transformations that can be applied to the mean positions
     std::vector<HitTransformation> fTransDefinitions;
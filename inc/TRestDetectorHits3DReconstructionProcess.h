@@ -25,12 +25,16 @@ class TRestDetectorHits3DReconstructionProcess : public TRestEventProcess {
     // unsaved parameters, temporary data members
     TH2D* htemp = nullptr;                      //!
     TRestEventProcess* fCompareProc = nullptr;  //!
+    double fMeanAmbiguity = 0;                  //! mean ambiguity of the layers of the last event
+    int fNLayers = 0;                           //! number of reconstructed layers of the last event
 
     // process parameters
     Double_t fZRange;
     bool fDraw;
     double fDrawThres;
     bool fDoEnergyScaling;
+    int fMaxStripeHits = 50;  // z slices with more stripe hits are skipped, no limit if <= 0
+    int fSliceThreads = 1;    // number of threads reconstructing the z slices, 0 for all the cores
 
    protected:
     void InitFromConfigFile() override;
@@ -45,6 +49,8 @@ class TRestDetectorHits3DReconstructionProcess : public TRestEventProcess {
     void EndProcess() override;
 
     double LogAmbiguity(const int& n, const int& m) { return log(Ambiguity(n, m)); }
+    double GetMeanAmbiguity() const { return fMeanAmbiguity; }
+    int GetNumberOfLayers() const { return fNLayers; }
     int Ambiguity(const int& n, const int& m);
     int Factorial(const int& n);
 
@@ -55,6 +61,6 @@ class TRestDetectorHits3DReconstructionProcess : public TRestEventProcess {
     // Destructor
     ~TRestDetectorHits3DReconstructionProcess();
 
-    ClassDefOverride(TRestDetectorHits3DReconstructionProcess, 1);
+    ClassDefOverride(TRestDetectorHits3DReconstructionProcess, 2);
 };
 #endif
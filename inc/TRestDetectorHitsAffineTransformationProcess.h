@@ -0,0 +1,75 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestDetectorHitsAffineTransformationProcess
+#define RestCore_TRestDetectorHitsAffineTransformationProcess
+
+#include <TRestDetectorHitsEvent.h>
+#include <TRestEventProcess.h>
+
+//! A process applying a sequence of rotations, translations, reflections and normalizations in one pass
+class TRestDetectorHitsAffineTransformationProcess : public TRestEventProcess {
+   private:
+    /// A pointer to the specific TRestDetectorHitsEvent input, that is also the output
+    TRestDetectorHitsEvent* fHitsEvent;  //!
+
+    void InitFromConfigFile() override;
+    void Initialize() override;
+
+    void AppendLinear(const Double_t* a, const TVector3& b);
+
+   protected:
+    /// The affine transformation as a row-major 3x4 matrix (the 4x4 homogeneous matrix without its last row)
+    std::vector<Double_t> fMatrix = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0};  //<
+
+    /// The factor applied to the energy of the hits
+    Double_t fEnergyScale = 1;  //<
+
+    /// The number of transformations combined in fMatrix and fEnergyScale
+    Int_t fNumberOfSteps = 0;  //<
+
+   public:
+    RESTValue GetInputEvent() const override { return fHitsEvent; }
+    RESTValue GetOutputEvent() const override { return fHitsEvent; }
+
+    TRestEvent* ProcessEvent(TRestEvent* inputEvent) override;
+
+    void PrintMetadata() override;
+
+    const char* GetProcessName() const override { return "hitsAffineTransformation"; }
+
+    void AddRotation(Double_t angle, const TVector3& axis, const TVector3& center);
+    void AddTranslation(const TVector3& translation);
+    void AddSpecular(const TVector3& normal, const TVector3& position);
+    void AddNormalization(Double_t factor);
+
+    TVector3 Transform(const TVector3& position) const;
+
+    inline Double_t GetEnergyScale() const { return fEnergyScale; }
+
+    TRestDetectorHitsAffineTransformationProcess();
+    TRestDetectorHitsAffineTransformationProcess(const char* configFilename);
+    ~TRestDetectorHitsAffineTransformationProcess();
+
+    ClassDefOverride(TRestDetectorHitsAffineTransformationProcess, 1);
+};
+#endif
@@ -56,6 +56,7 @@ class TRestDetectorHitsEvent : public TRestEvent {
    public:
     void AddHit(Double_t x, Double_t y, Double_t z, Double_t en, Double_t t = 0, REST_HitType type = XYZ);
     void AddHit(const TVector3& position, Double_t energy, Double_t time, REST_HitType type = XYZ);
+    void Reserve(size_t nHits);
 
     void Sort(bool(compareCondition)(const TRestHits::iterator& hit1,
                                      const TRestHits::iterator& hit2) = nullptr);
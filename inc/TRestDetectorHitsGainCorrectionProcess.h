@@ -0,0 +1,103 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestDetectorHitsGainCorrectionProcess
+#define RestCore_TRestDetectorHitsGainCorrectionProcess
+
+#include <TRestEventProcess.h>
+
+#include "TRestDetectorGainMap.h"
+#include "TRestDetectorHitsEvent.h"
+
+//! A process to correct the energy of each hit with the 2D/3D gain maps of a TRestDetectorGainMap
+class TRestDetectorHitsGainCorrectionProcess : public TRestEventProcess {
+   public:
+    /// A dense copy of a gain map histogram, used to find the gain at a position without TAxis::FindBin
+    struct GainGrid {
+        /// The number of axes of the map. 0 if the map is not defined.
+        Int_t dimension = 0;
+        Int_t nBins[3] = {1, 1, 1};
+        Double_t min[3] = {0, 0, 0};
+        Double_t invWidth[3] = {0, 0, 0};
+        /// The bin contents, with the X index running fastest
+        std::vector<Double_t> gain;
+        /// The map histogram, used directly if it has a variable bin size
+        TH1* histogram = nullptr;
+    };
+
+   private:
+    /// A pointer to the process input event
+    TRestDetectorHitsEvent* fInputEvent = nullptr;  //!
+
+    /// A pointer to the process output event
+    TRestDetectorHitsEvent* fOutputEvent = nullptr;  //!
+
+    /// A pointer to the gain map available to TRestRun
+    TRestDetectorGainMap* fCalib = nullptr;  //!
+
+    /// The lookup of the 2D gain map
+    GainGrid f2DGrid;  //!
+
+    /// The lookup of the 3D gain map
+    GainGrid f3DGrid;  //!
+
+    void Initialize() override;
+    void InitProcess() override;
+
+    static void BuildGrid(GainGrid& grid, TH1* histogram, Int_t dimension);
+    Double_t GetGain(const GainGrid& grid, Double_t x, Double_t y, Double_t z) const;
+
+   protected:
+    /// If true the gain is interpolated between the bin centers, otherwise the bin content is used
+    Bool_t fInterpolate = true;
+
+   public:
+    RESTValue GetInputEvent() const override { return fInputEvent; }
+    RESTValue GetOutputEvent() const override { return fOutputEvent; }
+
+    TRestEvent* ProcessEvent(TRestEvent* inputEvent) override;
+
+    /// It prints out the process parameters stored in the metadata structure
+    void PrintMetadata() override {
+        BeginPrintProcess();
+
+        RESTMetadata << "Interpolate : " << (fInterpolate ? "true" : "false") << RESTendl;
+
+        EndPrintProcess();
+    }
+
+    TRestMetadata* GetProcessMetadata() const { return fCalib; }
+
+    /// It sets the gain map used by the process, instead of the one of the run
+    void SetGainMap(TRestDetectorGainMap* calib) { fCalib = calib; }
+    void SetInterpolate(Bool_t interpolate) { fInterpolate = interpolate; }
+
+    /// Returns the name of this process
+    const char* GetProcessName() const override { return "hitsGainCorrection"; }
+
+    TRestDetectorHitsGainCorrectionProcess();
+    TRestDetectorHitsGainCorrectionProcess(const char* configFilename);
+    ~TRestDetectorHitsGainCorrectionProcess();
+
+    ClassDefOverride(TRestDetectorHitsGainCorrectionProcess, 1);
+};
+#endif
@@ -13,6 +13,8 @@
 
 #include <TRestDetectorHitsEvent.h>
 
+#include <unordered_map>
+
 #include "TRestEventProcess.h"
 
 class TRestDetectorHitsReductionProcess : public TRestEventProcess {
@@ -20,6 +22,27 @@ class TRestDetectorHitsReductionProcess : public TRestEventProcess {
     TRestDetectorHitsEvent* fInputHitsEvent;   //!
     TRestDetectorHitsEvent* fOutputHitsEvent;  //!
 
+    /// First hit of each occupied grid cell, indexed by the packed cell key
+    std::unordered_map<ULong64_t, Int_t> fCellHead;  //!
+    /// Next hit in the same grid cell, or -1
+    std::vector<Int_t> fCellNext;  //!
+    /// Grid cell of each hit, three coordinates per hit
+    std::vector<Long64_t> fCells;  //!
+    /// Cluster each hit has been merged into during the current pass, or -1
+    std::vector<Int_t> fCluster;  //!
+    /// Hits in the cells next to the absorbing hit, in increasing index order
+    std::vector<Int_t> fCandidates;  //!
+    /// Energy, and energy weighted x, y, z and time of each cluster, five values per hit
+    std::vector<Double_t> fSums;  //!
+    /// Position x, y, z and time of each hit before the pass, four values per hit
+    std::vector<Double_t> fHitValues;  //!
+    /// If each cluster has absorbed other hits during the current pass
+    std::vector<char> fAbsorbed;  //!
+    /// Type of each hit before the pass
+    std::vector<REST_HitType> fTypes;  //!
+
+    Bool_t MergePass(TRestHits* hits, Double_t distance);
+
     void InitFromConfigFile() override;
 
     void Initialize() override;
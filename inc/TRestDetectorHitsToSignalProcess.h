@@ -63,6 +63,9 @@ class TRestDetectorHitsToSignalProcess : public TRestEventProcess {
     /// The drift velocity in mm/us. If it is negative, it will be calculated from TRestDetectorGas.
     Double_t fDriftVelocity = -1;  // mm/us
 
+    /// If positive, the output signals charge is stored as 16-bit ADC values with this quantization.
+    Double_t fQuantization = -1;  //<
+
    public:
     RESTValue GetInputEvent() const override { return fHitsEvent; }
     RESTValue GetOutputEvent() const override { return fSignalEvent; }
@@ -78,6 +81,9 @@ class TRestDetectorHitsToSignalProcess : public TRestEventProcess {
         RESTMetadata << "Electric field : " << fElectricField * units("V/cm") << " V/cm" << RESTendl;
         RESTMetadata << "Gas pressure : " << fGasPressure << " atm" << RESTendl;
         RESTMetadata << "Drift velocity : " << fDriftVelocity << " mm/us" << RESTendl;
+        if (fQuantization > 0) {
+            RESTMetadata << "Charge quantization : " << fQuantization << RESTendl;
+        }
 
         EndPrintProcess();
     }
@@ -91,6 +97,6 @@ class TRestDetectorHitsToSignalProcess : public TRestEventProcess {
     TRestDetectorHitsToSignalProcess(const char* configFilename);
     ~TRestDetectorHitsToSignalProcess();
 
-    ClassDefOverride(TRestDetectorHitsToSignalProcess, 3);
+    ClassDefOverride(TRestDetectorHitsToSignalProcess, 4);
 };
 #endif
@@ -37,6 +37,7 @@ class TRestDetectorPositionMappingProcess : public TRestEventProcess {
     TVector2 fEnergyCutRange;
     TVector2 fNHitsCutRange;
     std::string fMappingSave;
+    std::string fAccumulatorSave;  // file to save the area sums for a later merge, none if empty
 
     double fNBinsX;
     double fNBinsY;
@@ -57,6 +58,12 @@ class TRestDetectorPositionMappingProcess : public TRestEventProcess {
     TRestEvent* ProcessEvent(TRestEvent* inputEvent) override;
     void EndProcess() override;
 
+    void FitAreaGain();
+    void SaveGainMap(std::string filename);
+    void SaveAccumulators(std::string filename);
+    Bool_t AddAccumulators(std::string filename);
+    TRestDetectorGainMap* GetGainMap() const { return fCalib; }
+
     double GetCorrection2(double x, double y);
     double GetCorrection3(double x, double y, double z);
 
@@ -69,6 +76,8 @@ class TRestDetectorPositionMappingProcess : public TRestEventProcess {
         RESTMetadata << (fCreateGainMap ? ">   " : "    ")
                      << "Create new correction std::map for each position" << RESTendl;
         RESTMetadata << "output mapping file: " << fMappingSave << RESTendl;
+        if (!fAccumulatorSave.empty())
+            RESTMetadata << "output accumulator file: " << fAccumulatorSave << RESTendl;
         RESTMetadata << "Energy cut for Threshold integral: " << RESTValue(fEnergyCutRange) << RESTendl;
         RESTMetadata << "Energy cut for NGoodSignals: " << RESTValue(fNHitsCutRange) << RESTendl;
         RESTMetadata << "Binning: " << fNBinsX << ", " << fNBinsY << ", " << fNBinsZ << RESTendl;
@@ -83,6 +92,6 @@ class TRestDetectorPositionMappingProcess : public TRestEventProcess {
 
     ~TRestDetectorPositionMappingProcess() override;
 
-    ClassDefOverride(TRestDetectorPositionMappingProcess, 1);
+    ClassDefOverride(TRestDetectorPositionMappingProcess, 2);
 };
 #endif
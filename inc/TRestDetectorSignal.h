@@ -27,13 +27,16 @@
 #include <TString.h>
 #include <TVector2.h>
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <optional>
 
+class TRestDetectorSignalEvent;
+
 class TRestDetectorSignal {
    private:
     Int_t GetMinIndex() const;
-    Int_t GetTimeIndex(Double_t t);
 
    protected:
     Int_t fSignalID = -1;
@@ -41,11 +44,76 @@ class TRestDetectorSignal {
     std::vector<Double_t> fSignalTime;    // Vector with the time of the signal
     std::vector<Double_t> fSignalCharge;  // Vector with the charge of the signal
 
-    // TODO: remove this and use readout
-    std::string fName;  // Name of the signal
-    std::string fType;  // Type of the signal
+    /// The time of the first point when the time axis is implicit
+    Double_t fTimeOrigin = 0;
+
+    /// The sampling time when the time axis is implicit. If zero, the times are stored at fSignalTime.
+    Double_t fTimeStep = 0;
+
+    /// Grid position of the first point of each segment of consecutive samples, when the implicit time
+    /// axis has gaps. If empty, the points are consecutive samples starting at fTimeOrigin.
+    std::vector<Int_t> fSegmentStart;
+
+    /// Index of the first point of each segment, in increasing order, starting at 0
+    std::vector<Int_t> fSegmentOffset;
+
+    /// The charge of the signal stored as 16-bit ADC values, used instead of fSignalCharge if fADCScale != 0
+    std::vector<Short_t> fSignalADC;
+
+    /// The charge value corresponding to one ADC unit. If zero, the charge is stored at fSignalCharge.
+    Double_t fADCScale = 0;
+
+    /// The charge value corresponding to an ADC value of zero
+    Double_t fADCOffset = 0;
+
+    /// Index of the signal name inside the labels dictionary. -1 if the signal has no name.
+    Int_t fNameId = -1;
+
+    /// Index of the signal type inside the labels dictionary. -1 if the signal has no type.
+    Int_t fTypeId = -1;
+
+    /// The event owning the labels dictionary. If nullptr the signal uses its own fLabels. It is set
+    /// by the event accessors, also by the const ones.
+    mutable TRestDetectorSignalEvent* fEvent = nullptr;  //!
+
+    /// Labels dictionary of signals that do not belong to an event, or that were read from an older
+    /// class version. If not empty, it is used instead of the dictionary of fEvent.
+    std::vector<std::string> fLabels;  //!
+
+    std::string GetLabel(Int_t id, Bool_t type) const;
+    Int_t InternLabel(const std::string& label);
+    void InvalidateEventExtrema();
+    void CopyPoints(const TRestDetectorSignal& signal);
+    std::unique_ptr<TGraph> NewGraph() const;
+
+    friend class TRestDetectorSignalEvent;
 
    public:
+    /// Signal statistics obtained in a single pass by ComputeStatistics
+    struct Statistics {
+        Double_t maxValue = 0;
+        Double_t minValue = 0;
+        Int_t maxIndex = 0;
+        Int_t minIndex = 0;
+        Double_t integral = 0;
+        Double_t baseLine = 0;
+        Double_t baseLineSigma = 0;
+        Double_t minTime = 0;
+        Double_t maxTime = 0;
+    };
+
+    /// A pulse of consecutive points over a threshold, found by GetPulses
+    struct Pulse {
+        Int_t firstIndex = 0;
+        Int_t lastIndex = 0;
+        Int_t maxIndex = 0;
+        Double_t maxValue = 0;
+        /// The sum of the pulse points
+        Double_t integral = 0;
+        /// The charge weighted mean time of the pulse points
+        Double_t time = 0;
+    };
+
     TGraph* fGraph;  //!
 
     std::vector<Int_t> fPointsOverThreshold;  //!
@@ -60,11 +128,14 @@ class TRestDetectorSignal {
     std::optional<std::pair<Double_t, Double_t>> GetPeakLandau();
     std::optional<std::pair<Double_t, Double_t>> GetPeakAget();
 
-    std::string GetSignalName() const { return fName; }
-    std::string GetSignalType() const { return fType; }
+    std::optional<std::pair<Double_t, Double_t>> GetPeakGaussFast(Double_t* residual = nullptr) const;
+    std::optional<std::pair<Double_t, Double_t>> GetPeakAgetFast(Double_t* residual = nullptr) const;
 
-    void SetSignalName(const std::string& name) { fName = name; }
-    void SetSignalType(const std::string& type) { fType = type; }
+    std::string GetSignalName() const { return GetLabel(fNameId, false); }
+    std::string GetSignalType() const { return GetLabel(fTypeId, true); }
+
+    void SetSignalName(const std::string& name) { fNameId = InternLabel(name); }
+    void SetSignalType(const std::string& type) { fTypeId = InternLabel(type); }
 
     // Getters
     TVector2 GetPoint(Int_t n) { return {GetTime(n), GetData(n)}; }
@@ -78,15 +149,21 @@ class TRestDetectorSignal {
             return;
         }
 
+        InvalidateEventExtrema();
+        SetDoubleStorage();
         fSignalCharge[bin] += data;
     }
 
     Int_t GetNumberOfPoints() const {
-        if (fSignalTime.size() != fSignalCharge.size()) {
+        const size_t nPoints = HasADCStorage() ? fSignalADC.size() : fSignalCharge.size();
+        if (HasImplicitTimeAxis()) {
+            return nPoints;
+        }
+        if (fSignalTime.size() != nPoints) {
             RESTError << "WARNING, the two std::vector sizes did not match" << RESTendl;
             exit(1);
         }
-        return fSignalTime.size();
+        return nPoints;
     }
 
     Double_t GetIntegralWithTime(Double_t startTime, Double_t endTime) const;
@@ -111,8 +188,55 @@ class TRestDetectorSignal {
     Double_t GetMinTime() const;
     Double_t GetMaxTime() const;
 
-    Double_t GetData(Int_t index) const { return fSignalCharge[index]; }
-    Double_t GetTime(Int_t index) const { return fSignalTime[index]; }
+    Double_t GetData(Int_t index) const {
+        if (HasADCStorage()) {
+            return fADCOffset + fADCScale * fSignalADC[index];
+        }
+        return fSignalCharge[index];
+    }
+    Double_t GetTime(Int_t index) const {
+        if (HasImplicitTimeAxis()) {
+            return fTimeOrigin + GetSampleIndex(index) * fTimeStep;
+        }
+        return fSignalTime[index];
+    }
+
+    Int_t GetTimeIndex(Double_t t) const;
+
+    /// It returns the position of the given point in the implicit time axis grid
+    Int_t GetSampleIndex(Int_t index) const {
+        if (fSegmentStart.empty()) {
+            return index;
+        }
+        const auto next = std::upper_bound(fSegmentOffset.begin(), fSegmentOffset.end(), index);
+        const Int_t segment = next - fSegmentOffset.begin() - 1;
+        return fSegmentStart[segment] + index - fSegmentOffset[segment];
+    }
+
+    /// It returns true if the signal times are given by fTimeOrigin and fTimeStep
+    Bool_t HasImplicitTimeAxis() const { return fTimeStep > 0; }
+    Double_t GetTimeStep() const { return fTimeStep; }
+
+    Bool_t SetImplicitTimeAxis(Double_t step = 0);
+    void SetExplicitTimeAxis();
+
+    /// It returns the number of blocks of consecutive samples in an implicit time axis
+    Int_t GetNumberOfSegments() const {
+        if (!fSegmentStart.empty()) {
+            return fSegmentStart.size();
+        }
+        return GetNumberOfPoints() > 0 ? 1 : 0;
+    }
+
+    void KeepRegions(const std::vector<std::pair<Int_t, Int_t>>& regions);
+
+    /// It returns true if the signal charge is stored as 16-bit ADC values
+    Bool_t HasADCStorage() const { return fADCScale != 0; }
+    Double_t GetADCScale() const { return fADCScale; }
+    Double_t GetADCOffset() const { return fADCOffset; }
+
+    Bool_t SetADCStorage(Double_t scale = 1, Double_t offset = 0);
+    void SetDoubleStorage();
 
     // Setters
     void SetSignalID(Int_t sID) { fSignalID = sID; }
@@ -124,6 +248,12 @@ class TRestDetectorSignal {
     void SetPoint(Double_t t, Double_t d);
     void SetPoint(Int_t index, Double_t t, Double_t d);
 
+    Statistics ComputeStatistics(Int_t baseLineStart = 0, Int_t baseLineEnd = 0) const;
+
+    void GetWindowAverages(Double_t window, std::vector<std::pair<Int_t, Double_t>>& averages) const;
+    void GetPulses(Double_t threshold, std::vector<Pulse>& pulses, Int_t minWidth = 1,
+                   Double_t minSeparation = 0) const;
+
     Double_t GetStandardDeviation(Int_t startBin, Int_t endBin);
     Double_t GetBaseLine(Int_t startBin, Int_t endBin);
     Double_t GetBaseLineSigma(Int_t startBin, Int_t endBin, Double_t baseline = 0);
@@ -150,8 +280,15 @@ class TRestDetectorSignal {
                            Double_t toTime);
 
     void Reset() {
+        InvalidateEventExtrema();
         fSignalTime.clear();
         fSignalCharge.clear();
+        fSignalADC.clear();
+        fTimeOrigin = 0;
+        fSegmentStart.clear();
+        fSegmentOffset.clear();
+        fADCScale = 0;
+        fADCOffset = 0;
     }
 
     void WriteSignalToTextFile(const TString& filename) const;
@@ -161,9 +298,22 @@ class TRestDetectorSignal {
 
     // Constructor
     TRestDetectorSignal();
+    TRestDetectorSignal(const TRestDetectorSignal& signal);
+    TRestDetectorSignal(TRestDetectorSignal&&) = default;
+    TRestDetectorSignal& operator=(const TRestDetectorSignal& signal);
+    TRestDetectorSignal& operator=(TRestDetectorSignal&&) = default;
     // Destructor
     ~TRestDetectorSignal();
 
-    ClassDef(TRestDetectorSignal, 4);
+    ClassDef(TRestDetectorSignal, 8);
 };
+
+#ifdef __ROOTCLING__
+// Signal names and types stored as strings by older class versions are moved to the signal own dictionary
+#pragma read sourceClass = "TRestDetectorSignal" targetClass = "TRestDetectorSignal" version = "[-4]" \
+    source = "std::string fName; std::string fType" target = "fNameId, fTypeId, fLabels" code = "{ \
+        fLabels.clear(); fNameId = -1; fTypeId = -1; \
+        if (!onfile.fName.empty()) { fLabels.push_back(onfile.fName); fNameId = fLabels.size() - 1; } \
+        if (!onfile.fType.empty()) { fLabels.push_back(onfile.fType); fTypeId = fLabels.size() - 1; } }"
+#endif
 #endif
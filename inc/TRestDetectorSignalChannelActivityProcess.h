@@ -35,6 +35,9 @@ class TRestDetectorSignalChannelActivityProcess : public TRestEventProcess {
     /// A pointer to the specific TRestDetectorSignalEvent input
     TRestDetectorSignalEvent* fSignalEvent;  //!
 
+    /// The statistics of each signal in the event being processed
+    std::vector<TRestDetectorSignal::Statistics> fStatistics;  //!
+
     /// A pointer to the readout metadata information accessible to TRestRun
     TRestDetectorReadout* fReadout;  //!
 
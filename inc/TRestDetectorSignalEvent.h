@@ -26,9 +26,12 @@
 #include <TRestEvent.h>
 
 #include <iostream>
+#include <map>
 
 #include "TRestDetectorSignal.h"
 
+class TRestDetectorReadout;
+
 class TRestDetectorSignalEvent : public TRestEvent {
    protected:
     Double_t fMinTime;   //!
@@ -36,11 +39,39 @@ class TRestDetectorSignalEvent : public TRestEvent {
     Double_t fMinValue;  //!
     Double_t fMaxValue;  //!
 
+    /// It is true if fMinTime, fMaxTime, fMinValue and fMaxValue correspond to the current signals.
+    /// It is reset by the methods modifying the signals and when a new event is read.
+    Bool_t fExtremaValid = false;  //!
+
     std::vector<TRestDetectorSignal> fSignal;  // Collection of signals that define the event
 
+    /// Dictionary of the signal names and types, referenced by id from each signal
+    std::vector<std::string> fSignalLabels;
+
+    /// Reverse lookup of fSignalLabels. It is cleared when the event is initialized or read, and
+    /// rebuilt by the next call to InternSignalLabel.
+    std::map<std::string, Int_t> fSignalLabelIds;  //!
+
+    /// The readout used to resolve the name and type of the signals without labels
+    TRestDetectorReadout* fReadout = nullptr;  //!
+
+    /// Signals released by Initialize, whose buffers are re-used by the signals of the next event
+    std::vector<TRestDetectorSignal> fSignalPool;  //!
+
+    /// The maximum number of signals released at once, which limits the size of fSignalPool
+    size_t fSignalPoolLimit = 0;  //!
+
    private:
     void SetMaxAndMin();
 
+    /// It forces the extrema to be recomputed on the next query. It is also called by the signals of
+    /// the event when their points are modified.
+    inline void InvalidateExtrema() { fExtremaValid = false; }
+    TRestDetectorSignal& NewSignal();
+    void ReleaseSignals(size_t first);
+
+    friend class TRestDetectorSignal;
+
    public:
     inline Bool_t signalIDExists(Int_t sID) {
         if (GetSignalIndex(sID) == -1) {
@@ -50,20 +81,49 @@ class TRestDetectorSignalEvent : public TRestEvent {
     }
 
     inline void SortSignals() {
+        InvalidateExtrema();
         for (int n = 0; n < GetNumberOfSignals(); n++) {
             fSignal[n].Sort();
         }
     }
 
+    /// It drops the stored time values of every uniformly sampled signal. See TRestDetectorSignal.
+    inline void SetImplicitTimeAxis(Double_t step = 0) {
+        InvalidateExtrema();
+        for (int n = 0; n < GetNumberOfSignals(); n++) {
+            fSignal[n].SetImplicitTimeAxis(step);
+        }
+    }
+
+    Bool_t SetADCStorage(Double_t quantization = 1);
+
     // Setters
     void AddSignal(const TRestDetectorSignal& signal);
+    void AddSignal(TRestDetectorSignal&& signal);
+    void CopySignals(const TRestDetectorSignalEvent& event);
     void AddChargeToSignal(Int_t signalID, Double_t time, Double_t charge);
 
     void RemoveSignalWithId(Int_t sId);
+    Int_t RemoveEmptySignals();
+
+    Int_t InternSignalLabel(const std::string& label);
 
     // Getters
     inline Int_t GetNumberOfSignals() const { return fSignal.size(); }
-    inline TRestDetectorSignal* GetSignal(Int_t n) { return &fSignal[n]; }
+    /// The number of released signals kept for re-use
+    inline size_t GetSignalPoolSize() const { return fSignalPool.size(); }
+    /// The signal may be modified through the returned pointer. The event extrema are invalidated by
+    /// the signal methods modifying its points, also when the pointer is kept across extrema queries.
+    inline TRestDetectorSignal* GetSignal(Int_t n) {
+        fSignal[n].fEvent = this;
+        return &fSignal[n];
+    }
+
+    /// Read-only access to a signal, which keeps the event extrema
+    inline const TRestDetectorSignal* GetSignal(Int_t n) const {
+        fSignal[n].fEvent = const_cast<TRestDetectorSignalEvent*>(this);
+        return &fSignal[n];
+    }
 
     inline TRestDetectorSignal* GetSignalById(Int_t sid) {
         Int_t index = GetSignalIndex(sid);
@@ -71,9 +131,23 @@ class TRestDetectorSignalEvent : public TRestEvent {
             return nullptr;
         }
 
-        return &fSignal[index];
+        return GetSignal(index);
     }
 
+    /// It returns the label registered with the given id, or an empty string if it is not registered
+    std::string GetSignalLabel(Int_t id) const {
+        if (id < 0 || id >= (Int_t)fSignalLabels.size()) {
+            return "";
+        }
+        return fSignalLabels[id];
+    }
+
+    std::string GetReadoutLabel(Int_t signalID, Bool_t type) const;
+
+    /// The readout giving the name and type of the signals without labels. See TRestDetectorSignal.
+    void SetReadout(TRestDetectorReadout* readout) { fReadout = readout; }
+    TRestDetectorReadout* GetReadout() const { return fReadout; }
+
     Int_t GetSignalIndex(Int_t signalID);
 
     Double_t GetIntegral(Int_t startBin = 0, Int_t endBin = 0);
@@ -84,6 +158,22 @@ class TRestDetectorSignalEvent : public TRestEvent {
 
     Double_t GetIntegralWithTime(Double_t startTime, Double_t endTime);
 
+    void ComputeStatistics(std::vector<TRestDetectorSignal::Statistics>& statistics, Int_t baseLineStart = 0,
+                           Int_t baseLineEnd = 0) const;
+
+    /// The pulse fit methods of GetPeaks
+    enum class PeakMethod { GaussFit, LandauFit, AgetFit, GaussFast, AgetFast, Unknown };
+
+    static PeakMethod ResolvePeakMethod(const std::string& method);
+    static Bool_t CanFitInThreads();
+
+    std::vector<std::optional<std::pair<Double_t, Double_t>>> GetPeaks(
+        PeakMethod method, Int_t nThreads = 1, Double_t fastFitTolerance = 0.1,
+        const std::vector<Int_t>* selection = nullptr);
+    std::vector<std::optional<std::pair<Double_t, Double_t>>> GetPeaks(
+        const std::string& method, Int_t nThreads = 1, Double_t fastFitTolerance = 0.1,
+        const std::vector<Int_t>* selection = nullptr);
+
     // Default
     void Initialize();
     void PrintEvent();
@@ -95,6 +185,13 @@ class TRestDetectorSignalEvent : public TRestEvent {
     // Destructor
     virtual ~TRestDetectorSignalEvent();
 
-    ClassDef(TRestDetectorSignalEvent, 1);  // REST event superclass
+    ClassDef(TRestDetectorSignalEvent, 2);  // REST event superclass
 };
+
+#ifdef __ROOTCLING__
+// The labels reverse lookup and the extrema are not stored, and they must not be used with a new event
+#pragma read sourceClass = "TRestDetectorSignalEvent" targetClass = "TRestDetectorSignalEvent" \
+    version = "[1-]" source = "" target = "fSignalLabelIds, fExtremaValid" \
+    code = "{ fSignalLabelIds.clear(); fExtremaValid = false; }"
+#endif
 #endif
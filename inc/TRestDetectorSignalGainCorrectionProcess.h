@@ -0,0 +1,79 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestDetectorSignalGainCorrectionProcess
+#define RestCore_TRestDetectorSignalGainCorrectionProcess
+
+#include <TRestEventProcess.h>
+
+#include "TRestDetectorGainMap.h"
+#include "TRestDetectorSignalEvent.h"
+
+//! A process to correct the charge of each signal with the channel gains of a TRestDetectorGainMap
+class TRestDetectorSignalGainCorrectionProcess : public TRestEventProcess {
+   private:
+    /// A pointer to the specific TRestDetectorSignalEvent input, that is also the output
+    TRestDetectorSignalEvent* fSignalEvent;  //!
+
+    /// A pointer to the gain map available to TRestRun
+    TRestDetectorGainMap* fCalib;  //!
+
+    /// The gain of each channel, indexed by daq id
+    std::vector<Double_t> fGainTable;  //!
+
+    void Initialize() override;
+    void InitProcess() override;
+
+   protected:
+    /// The gain given to the channels not found in the gain map
+    Double_t fDefaultGain = 1.;
+
+   public:
+    RESTValue GetInputEvent() const override { return fSignalEvent; }
+    RESTValue GetOutputEvent() const override { return fSignalEvent; }
+
+    TRestEvent* ProcessEvent(TRestEvent* inputEvent) override;
+
+    /// It prints out the process parameters stored in the metadata structure
+    void PrintMetadata() override {
+        BeginPrintProcess();
+
+        RESTMetadata << "Default gain : " << fDefaultGain << RESTendl;
+
+        EndPrintProcess();
+    }
+
+    TRestMetadata* GetProcessMetadata() const { return fCalib; }
+
+    /// It sets the gain map used by the process, instead of the one of the run
+    void SetGainMap(TRestDetectorGainMap* calib) { fCalib = calib; }
+
+    /// Returns the name of this process
+    const char* GetProcessName() const override { return "signalGainCorrection"; }
+
+    TRestDetectorSignalGainCorrectionProcess();
+    TRestDetectorSignalGainCorrectionProcess(const char* configFilename);
+    ~TRestDetectorSignalGainCorrectionProcess();
+
+    ClassDefOverride(TRestDetectorSignalGainCorrectionProcess, 1);
+};
+#endif
@@ -0,0 +1,118 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestDetectorSignalNoiseProcess
+#define RestCore_TRestDetectorSignalNoiseProcess
+
+#include <TRandom3.h>
+#include <TRestEventProcess.h>
+
+#include <complex>
+
+#include "TRestDetectorSignalEvent.h"
+
+//! A process to add noise with a given power spectrum to the signals, optionally correlated between chips
+class TRestDetectorSignalNoiseProcess : public TRestEventProcess {
+   private:
+    /// A pointer to the specific TRestDetectorSignalEvent input, that is also the output
+    TRestDetectorSignalEvent* fSignalEvent;  //!
+
+    /// A pointer to the random generator, seeded for each event from fSeed and the event id
+    TRandom3* fRandom = nullptr;  //!
+
+    /// The amplitude of each frequency component, for the current number of samples
+    std::vector<Double_t> fFilter;  //!
+
+    /// The frequency components of the noise being generated
+    std::vector<std::complex<Double_t>> fSpectrum;  //!
+
+    /// The noise series of the event, one row per signal followed by one row per chip
+    std::vector<Double_t> fNoise;  //!
+
+    /// The chip row of each signal at fNoise
+    std::vector<Int_t> fChipIndex;  //!
+
+    void Initialize() override;
+    void InitProcess() override;
+
+    void LoadDefaultConfig();
+
+    void BuildFilter(Int_t size);
+    static void FFT(std::vector<std::complex<Double_t>>& data);
+
+   protected:
+    /// The noise RMS, in the units of the signal charge
+    Double_t fNoiseLevel = 1.;
+
+    /// The noise power is proportional to 1/f^fSpectralIndex. 0 for white noise and 1 for pink noise.
+    Double_t fSpectralIndex = 0.;
+
+    /// The cutoff frequency, in MHz, of the first order low pass filter shaping the noise. Not used if 0.
+    Double_t fCutoffFrequency = 0.;
+
+    /// The sampling time, in us, of the signals
+    Double_t fSampling = 1.;
+
+    /// The number of consecutive daq channels read by the same chip. Not used if 0.
+    Int_t fChipChannels = 0;
+
+    /// The fraction of the noise power that is common to every channel of the same chip
+    Double_t fChipCorrelation = 0.;
+
+    /// The seed to be used for the random generator. If 0, a random seed is used.
+    ULong_t fSeed = 0;
+
+   public:
+    RESTValue GetInputEvent() const override { return fSignalEvent; }
+    RESTValue GetOutputEvent() const override { return fSignalEvent; }
+
+    TRestEvent* ProcessEvent(TRestEvent* inputEvent) override;
+
+    /// It prints out the process parameters stored in the metadata structure
+    void PrintMetadata() override {
+        BeginPrintProcess();
+
+        RESTMetadata << "Noise level : " << fNoiseLevel << RESTendl;
+        RESTMetadata << "Spectral index : " << fSpectralIndex << RESTendl;
+        if (fCutoffFrequency > 0) {
+            RESTMetadata << "Cutoff frequency : " << fCutoffFrequency << " MHz" << RESTendl;
+        }
+        RESTMetadata << "Sampling : " << fSampling << " us" << RESTendl;
+        if (fChipChannels > 0) {
+            RESTMetadata << "Chip channels : " << fChipChannels << RESTendl;
+            RESTMetadata << "Chip correlation : " << fChipCorrelation << RESTendl;
+        }
+        RESTMetadata << "Seed : " << fSeed << RESTendl;
+
+        EndPrintProcess();
+    }
+
+    /// Returns the name of this process
+    const char* GetProcessName() const override { return "signalNoise"; }
+
+    TRestDetectorSignalNoiseProcess();
+    TRestDetectorSignalNoiseProcess(const char* configFilename);
+    ~TRestDetectorSignalNoiseProcess();
+
+    ClassDefOverride(TRestDetectorSignalNoiseProcess, 1);
+};
+#endif
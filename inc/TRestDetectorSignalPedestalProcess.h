@@ -0,0 +1,111 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestDetectorSignalPedestalProcess
+#define RestCore_TRestDetectorSignalPedestalProcess
+
+#include <TRestEventProcess.h>
+
+#include <cmath>
+#include <map>
+
+#include "TRestDetectorSignalEvent.h"
+
+//! A process to track the pedestal and noise of each channel across events and subtract the pedestal
+class TRestDetectorSignalPedestalProcess : public TRestEventProcess {
+   private:
+    /// A pointer to the specific TRestDetectorSignalEvent input, that is also the output
+    TRestDetectorSignalEvent* fSignalEvent;  //!
+
+    /// The pedestal of each channel, indexed by daq id
+    std::vector<Double_t> fPedestal;  //!
+
+    /// The noise variance of each channel, indexed by daq id
+    std::vector<Double_t> fVariance;  //!
+
+    /// The number of events used to estimate the pedestal of each channel, indexed by daq id
+    std::vector<Int_t> fEntries;  //!
+
+    /// The variance of a unit gaussian truncated at fPointThreshold, to correct the noise variance
+    Double_t fTruncatedVariance = 1;  //!
+
+    /// A copy of the charge values of a signal, used to obtain the median at the first event of a channel
+    std::vector<Double_t> fValues;  //!
+
+    /// The pedestal and noise of the channels of the event, published as observables
+    std::map<Int_t, Double_t> fPedestalMap;  //!
+    std::map<Int_t, Double_t> fNoiseMap;     //!
+
+    void Initialize() override;
+    void InitProcess() override;
+
+    void LoadDefaultConfig();
+
+    void InitChannel(Int_t id, const TRestDetectorSignal* signal);
+
+   protected:
+    /// The number of events over which the pedestal and noise estimations are averaged
+    Double_t fTimeConstant = 100.;
+
+    /// Points further than this number of noise sigmas from the pedestal are not used to update it
+    Double_t fPointThreshold = 3.;
+
+    /// If true the pedestal of each channel is subtracted from its signal
+    Bool_t fSubtractPedestal = true;
+
+   public:
+    RESTValue GetInputEvent() const override { return fSignalEvent; }
+    RESTValue GetOutputEvent() const override { return fSignalEvent; }
+
+    TRestEvent* ProcessEvent(TRestEvent* inputEvent) override;
+
+    /// It returns the current pedestal of a channel, or 0 if the channel has not been found yet
+    Double_t GetPedestal(Int_t id) const {
+        return (id >= 0 && id < (Int_t)fEntries.size() && fEntries[id] > 0) ? fPedestal[id] : 0;
+    }
+
+    /// It returns the current noise sigma of a channel, or 0 if the channel has not been found yet
+    Double_t GetNoise(Int_t id) const {
+        return (id >= 0 && id < (Int_t)fEntries.size() && fEntries[id] > 0) ? std::sqrt(fVariance[id]) : 0;
+    }
+
+    /// It prints out the process parameters stored in the metadata structure
+    void PrintMetadata() override {
+        BeginPrintProcess();
+
+        RESTMetadata << "Time constant : " << fTimeConstant << " events" << RESTendl;
+        RESTMetadata << "Point threshold : " << fPointThreshold << " sigmas" << RESTendl;
+        RESTMetadata << "Subtract pedestal : " << (fSubtractPedestal ? "true" : "false") << RESTendl;
+
+        EndPrintProcess();
+    }
+
+    /// Returns the name of this process
+    const char* GetProcessName() const override { return "signalPedestal"; }
+
+    TRestDetectorSignalPedestalProcess();
+    TRestDetectorSignalPedestalProcess(const char* configFilename);
+    ~TRestDetectorSignalPedestalProcess();
+
+    ClassDefOverride(TRestDetectorSignalPedestalProcess, 1);
+};
+#endif
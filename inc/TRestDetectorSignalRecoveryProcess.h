@@ -36,9 +36,15 @@ class TRestDetectorSignalRecoveryProcess : public TRestEventProcess {
     /// A pointer to the specific TRestDetectorSignalEvent input
     TRestDetectorSignalEvent* fInputSignalEvent;  //!
 
-    /// A pointer to the specific TRestDetectorSignalEvent input
+    /// A pointer to the specific TRestDetectorSignalEvent output
     TRestDetectorSignalEvent* fOutputSignalEvent;  //!
 
+    /// Working copies of the neighbour signals used to recover the channels of the current event
+    std::map<Int_t, TRestDetectorSignal> fNeighbourSignals;  //!
+
+    /// The signals recovered in the current event
+    std::vector<TRestDetectorSignal> fRecoveredSignals;  //!
+
     /// A pointer to the readout that will be extracted from TRestRun
     TRestDetectorReadout* fReadout;  //!
 
@@ -48,6 +54,8 @@ class TRestDetectorSignalRecoveryProcess : public TRestEventProcess {
 
     int GetAdjacentSignalIds(Int_t signalId, Int_t& idLeft, Int_t& idRight);
 
+    TRestDetectorSignal* GetNeighbourSignal(Int_t signalId);
+
    public:
     RESTValue GetInputEvent() const override { return fInputSignalEvent; }
     RESTValue GetOutputEvent() const override { return fOutputSignalEvent; }
@@ -57,6 +65,12 @@ class TRestDetectorSignalRecoveryProcess : public TRestEventProcess {
 
     void LoadConfig(const std::string& configFilename, const std::string& name = "");
 
+    /// It sets the daq ids of the channels to be recovered
+    void SetChannelIds(const std::vector<Int_t>& channelIds) { fChannelIds = channelIds; }
+
+    /// It sets the readout used to find the adjacent channels, which is otherwise taken from TRestRun
+    void SetReadout(TRestDetectorReadout* readout) { fReadout = readout; }
+
     /// It prints out the process parameters stored in the metadata structure
     void PrintMetadata() override {
         BeginPrintProcess();
@@ -45,10 +45,65 @@ class TRestDetectorSignalToHitsProcess : public TRestEventProcess {
     /// A pointer to the detector gas definition accessible to TRestRun
     TRestDetectorGas* fGas;  //!
 
+    /// The signal to hits kernels, one for each method or family of methods
+    enum class Method { OnlyMax, TripleMax, TripleMaxAverage, Fit, QCenter, All, IntWindow, Peaks, Unknown };
+
+    /// The kernel resolved from fMethod at InitProcess
+    Method fMethodId = Method::Unknown;  //!
+
+    /// The TRestDetectorSignalEvent::GetPeaks method resolved from fMethod, used by the fit methods
+    TRestDetectorSignalEvent::PeakMethod fPeakMethod = TRestDetectorSignalEvent::PeakMethod::Unknown;  //!
+
+    /// The readout information required to place the hits of a daq channel
+    struct ChannelInfo {
+        Bool_t valid = false;
+        Double_t x = 0;
+        Double_t y = 0;
+        Double_t zPosition = 0;
+        Double_t fieldZDirection = 0;
+        REST_HitType type = XYZ;
+    };
+
+    /// The readout information of each daq channel, indexed by daq id
+    std::vector<ChannelInfo> fChannelInfo;  //!
+
+    /// The window averages of the signal being converted by the intwindow method
+    std::vector<std::pair<Int_t, Double_t>> fWindowAverages;  //!
+
+    /// The pulses of the signal being converted by the peaks method
+    std::vector<TRestDetectorSignal::Pulse> fPulses;  //!
+
+    /// The signals fitted by the fit methods, the ones with a readout position
+    std::vector<Int_t> fFitSignals;  //!
+
     void Initialize() override;
 
     void LoadDefaultConfig();
 
+    static Method ResolveMethod(const TString& method);
+    void BuildChannelTable();
+
+    /// It returns the readout information of a daq channel, or nullptr if it is not in the readout
+    inline const ChannelInfo* GetChannelInfo(Int_t signalID) const {
+        if (signalID < 0 || signalID >= (Int_t)fChannelInfo.size() || !fChannelInfo[signalID].valid)
+            return nullptr;
+        return &fChannelInfo[signalID];
+    }
+
+    /// It returns the z coordinate of a hit found at the given time in a daq channel
+    inline Double_t GetHitZ(const ChannelInfo& info, Double_t time) const {
+        return info.zPosition + info.fieldZDirection * (time * fDriftVelocity);
+    }
+
+    void AddOnlyMaxHits();
+    void AddTripleMaxHits();
+    void AddTripleMaxAverageHits();
+    void AddFitHits();
+    void AddQCenterHits();
+    void AddAllHits();
+    void AddIntWindowHits();
+    void AddPeakHits();
+
    protected:
     /// The electric field in standard REST units (V/mm). Only relevant if TRestDetectorGas is used.
     Double_t fElectricField = -1;
@@ -65,9 +120,23 @@ class TRestDetectorSignalToHitsProcess : public TRestEventProcess {
     // Time window to integrate in case intwindow method is requested, units (us)
     Double_t fIntWindow = 5;
 
-    // Threshold value for in case intwindow method is requested
+    // Threshold value for in case intwindow or peaks method is requested
     Double_t fThreshold = 100.;
 
+    /// Minimum number of points over threshold of a pulse, in case peaks method is requested
+    Int_t fPeakMinWidth = 2;
+
+    /// Minimum time (us) between the maxima of two pulses, in case peaks method is requested.
+    /// Closer pulses are merged.
+    Double_t fPeakMinSeparation = 0;
+
+    /// Maximum relative residual accepted from the gaussFast and agetFast estimators before
+    /// falling back to the corresponding ROOT fit
+    Double_t fFastFitTolerance = 0.1;
+
+    /// Number of threads used to fit the signals of each event with the fit based methods
+    Int_t fFitThreads = 1;
+
    public:
     RESTValue GetInputEvent() const override { return fSignalEvent; }
     RESTValue GetOutputEvent() const override { return fHitsEvent; }
@@ -77,6 +146,11 @@ class TRestDetectorSignalToHitsProcess : public TRestEventProcess {
 
     void LoadConfig(const std::string& configFilename, const std::string& name = "");
 
+    /// It sets the readout used to place the hits, instead of the one of the run
+    void SetReadout(TRestDetectorReadout* readout) { fReadout = readout; }
+    void SetMethod(const TString& method) { fMethod = method; }
+    void SetDriftVelocity(Double_t driftVelocity) { fDriftVelocity = driftVelocity; }
+
     /// It prints out the process parameters stored in the metadata structure
     void PrintMetadata() override {
         BeginPrintProcess();
@@ -89,6 +163,17 @@ class TRestDetectorSignalToHitsProcess : public TRestEventProcess {
             RESTMetadata << "Threshold : " << fThreshold << " ADC" << RESTendl;
             RESTMetadata << "Integral window : " << fIntWindow << " us" << RESTendl;
         }
+        if (fMethod == "peaks") {
+            RESTMetadata << "Threshold : " << fThreshold << " ADC" << RESTendl;
+            RESTMetadata << "Peak minimum width : " << fPeakMinWidth << " points" << RESTendl;
+            RESTMetadata << "Peak minimum separation : " << fPeakMinSeparation << " us" << RESTendl;
+        }
+        if (fMethod == "gaussFast" || fMethod == "agetFast") {
+            RESTMetadata << "Fast fit tolerance : " << fFastFitTolerance << RESTendl;
+        }
+        if (fMethod.EndsWith("Fit") || fMethod.EndsWith("Fast")) {
+            RESTMetadata << "Fit threads : " << fFitThreads << RESTendl;
+        }
 
         EndPrintProcess();
     }
@@ -100,6 +185,6 @@ class TRestDetectorSignalToHitsProcess : public TRestEventProcess {
     TRestDetectorSignalToHitsProcess(const char* configFilename);
     ~TRestDetectorSignalToHitsProcess() override;
 
-    ClassDefOverride(TRestDetectorSignalToHitsProcess, 4);
+    ClassDefOverride(TRestDetectorSignalToHitsProcess, 6);
 };
 #endif
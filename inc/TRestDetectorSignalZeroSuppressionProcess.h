@@ -0,0 +1,84 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+#ifndef RestCore_TRestDetectorSignalZeroSuppressionProcess
+#define RestCore_TRestDetectorSignalZeroSuppressionProcess
+
+#include <TRestEventProcess.h>
+
+#include "TRestDetectorSignalEvent.h"
+
+//! A process to keep only the regions of interest of the signals, around the points over threshold
+class TRestDetectorSignalZeroSuppressionProcess : public TRestEventProcess {
+   private:
+    /// A pointer to the specific TRestDetectorSignalEvent input, that is also the output
+    TRestDetectorSignalEvent* fSignalEvent;  //!
+
+    /// The regions of interest of the signal being processed, re-used between signals
+    std::vector<std::pair<Int_t, Int_t>> fRegions;  //!
+
+    void Initialize() override;
+
+    void LoadDefaultConfig();
+
+   protected:
+    /// The range of samples used to calculate the baseline and its fluctuation, for signals without gaps
+    TVector2 fBaseLineRange = TVector2(5, 55);
+
+    /// A point is over threshold if it is this number of baseline sigmas over the baseline
+    Double_t fPointThreshold = 3.;
+
+    /// The number of points kept before each point over threshold
+    Int_t fPreSamples = 5;
+
+    /// The number of points kept after each point over threshold
+    Int_t fPostSamples = 10;
+
+   public:
+    RESTValue GetInputEvent() const override { return fSignalEvent; }
+    RESTValue GetOutputEvent() const override { return fSignalEvent; }
+
+    TRestEvent* ProcessEvent(TRestEvent* inputEvent) override;
+
+    /// It prints out the process parameters stored in the metadata structure
+    void PrintMetadata() override {
+        BeginPrintProcess();
+
+        RESTMetadata << "Baseline range : ( " << fBaseLineRange.X() << " , " << fBaseLineRange.Y() << " )"
+                     << RESTendl;
+        RESTMetadata << "Point threshold : " << fPointThreshold << " sigmas" << RESTendl;
+        RESTMetadata << "Pre samples : " << fPreSamples << RESTendl;
+        RESTMetadata << "Post samples : " << fPostSamples << RESTendl;
+
+        EndPrintProcess();
+    }
+
+    /// Returns the name of this process
+    const char* GetProcessName() const override { return "signalZeroSuppression"; }
+
+    TRestDetectorSignalZeroSuppressionProcess();
+    TRestDetectorSignalZeroSuppressionProcess(const char* configFilename);
+    ~TRestDetectorSignalZeroSuppressionProcess();
+
+    ClassDefOverride(TRestDetectorSignalZeroSuppressionProcess, 1);
+};
+#endif
@@ -37,6 +37,8 @@ class TRestDetectorSingleChannelAnalysisProcess : public TRestEventProcess {
     TVector2 fNGoodSignalsCutRange;
     TVector2 fSpecFitRange;
     std::string fCalibSave;
+    std::string fAccumulatorSave;  // file to save the channel spectra for a later merge, none if empty
+    Int_t fFitThreads = 1;  // number of threads used to fit the channel spectra, 0 for all the cores
 
     // analysis result
     std::map<int, TH1D*> fChannelThrIntegral;  //-> [channel id, sum]
@@ -44,11 +46,25 @@ class TRestDetectorSingleChannelAnalysisProcess : public TRestEventProcess {
     std::map<int, double> fChannelGain;        // [MM id, channel gain]
     std::map<int, double> fChannelGainError;   // [MM id, channel gain error]
 
+    // dense storage indexed by daq id, filled during the event loop
+    std::vector<Double_t> fChannelSpectra;    //! [daq id * (bins + 2) + bin, counts]
+    std::vector<Long64_t> fChannelEntries;    //! [daq id, entries], -1 for undefined channels
+    std::vector<Double_t> fChannelGainTable;  //! [daq id, gain], NaN for unrecorded channels
+
+    static constexpr Int_t kSpectrumBins = 100;
+
+    void FillChannelSpectrum(int id, double value, bool fill = true);
+    void BuildChannelSpectra();
+
    public:
     RESTValue GetInputEvent() const override { return fSignalEvent; }
     RESTValue GetOutputEvent() const override { return fSignalEvent; }
 
     void FitChannelGain();
+    void SaveAccumulators(std::string filename);
+    Bool_t AddAccumulators(std::string filename);
+    TRestDetectorGainMap* GetGainMap() const { return fCalib; }
+    void SetFitThreads(Int_t nThreads) { fFitThreads = nThreads; }
     // See comments on CXX
     void SaveGainMetadata(std::string filename);
     void InitProcess() override;
@@ -66,9 +82,12 @@ class TRestDetectorSingleChannelAnalysisProcess : public TRestEventProcess {
         RESTMetadata << (fCreateGainMap ? ">   " : "    ")
                      << "Create new correction std::map for each channel" << RESTendl;
         RESTMetadata << "output mapping file: " << fCalibSave << RESTendl;
+        if (!fAccumulatorSave.empty())
+            RESTMetadata << "output accumulator file: " << fAccumulatorSave << RESTendl;
         RESTMetadata << "Energy cut for Threshold integral: " << RESTValue(fThrIntegralCutRange) << RESTendl;
         RESTMetadata << "Energy cut for NGoodSignals: " << RESTValue(fNGoodSignalsCutRange) << RESTendl;
         RESTMetadata << "Fit range for the spectra: " << RESTValue(fSpecFitRange) << RESTendl;
+        RESTMetadata << "Threads used to fit the spectra: " << fFitThreads << RESTendl;
 
         EndPrintProcess();
     }
@@ -81,6 +100,6 @@ class TRestDetectorSingleChannelAnalysisProcess : public TRestEventProcess {
     // Destructor
     ~TRestDetectorSingleChannelAnalysisProcess();
 
-    ClassDefOverride(TRestDetectorSingleChannelAnalysisProcess, 1);
+    ClassDefOverride(TRestDetectorSingleChannelAnalysisProcess, 3);
 };
 #endif
@@ -39,6 +39,15 @@ class TRestDetectorTriggerAnalysisProcess : public TRestEventProcess {
     /// A std::vector to temporary the extracted threshold value from the corresponding observable
     std::vector<double> fThreshold;  //!
 
+    /// The time bin corresponding to the first element of the summed waveform arrays
+    Int_t fFirstBin = 0;  //!
+
+    /// Prefix sum of the event charge found exactly at each sampling time
+    std::vector<Double_t> fGridChargeSum;  //!
+
+    /// Prefix sum of the event charge found between each sampling time and the next one
+    std::vector<Double_t> fBinChargeSum;  //!
+
     void Initialize() override;
 
     void LoadDefaultConfig();
@@ -60,6 +69,12 @@ class TRestDetectorTriggerAnalysisProcess : public TRestEventProcess {
     void InitProcess() override;
     TRestEvent* ProcessEvent(TRestEvent* inputEvent) override;
 
+    void FillSummedWaveform(const TRestDetectorSignalEvent& event, Int_t firstBin, Int_t lastBin);
+    Double_t GetWindowIntegral(Int_t startBin, Int_t endBin) const;
+
+    /// Returns the sampling time in us
+    Double_t GetSampling() const { return fSampling; }
+
     void LoadConfig(const std::string& configFilename, const std::string& name = "");
 
     /// Prints on screen the metadata information registered by this process
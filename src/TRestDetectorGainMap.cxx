@@ -1,6 +1,10 @@
 
 #include "TRestDetectorGainMap.h"
 
+#include <cstring>
+#include <limits>
+#include <memory>
+
 #include "TGraph2D.h"
 #include "TLegend.h"
 #include "TRandom.h"
@@ -12,8 +16,449 @@ using namespace std;
 
 ClassImp(TRestDetectorGainMap);
 
+namespace {
+/// Identifier found at the beginning of the binary gain map files
+constexpr char kBinaryMagic[8] = {'R', 'E', 'S', 'T', 'G', 'A', 'I', 'N'};
+constexpr Int_t kBinaryVersion = 2;
+
+/// Value written after the identifier, read as a different value on machines of another byte order
+constexpr Int_t kByteOrderMark = 0x01020304;
+constexpr Int_t kSwappedByteOrderMark = 0x04030201;
+
+/// The binning of a gain map histogram, as stored in the text and binary files
+struct MapHeader {
+    Int_t nBins[3] = {1, 1, 1};
+    Int_t dimension = 0;
+    Double_t min[3] = {0, 0, 0};
+    Double_t max[3] = {0, 0, 0};
+    Double_t entries = 0;
+};
+
+/// It fills the binning of the histogram, returning false if it has a variable bin size
+Bool_t GetMapHeader(const TH1* histogram, Int_t dimension, MapHeader& header) {
+    const TAxis* axes[3] = {histogram->GetXaxis(), histogram->GetYaxis(), histogram->GetZaxis()};
+    header.dimension = dimension;
+    for (int d = 0; d < dimension; d++) {
+        if (axes[d]->IsVariableBinSize()) {
+            return false;
+        }
+        header.nBins[d] = axes[d]->GetNbins();
+        header.min[d] = axes[d]->GetXmin();
+        header.max[d] = axes[d]->GetXmax();
+    }
+    header.entries = histogram->GetEntries();
+    return true;
+}
+
+/// It checks the binning read from a file, with at most `maxBins` bins in total
+Bool_t IsValidMapHeader(const MapHeader& header, Int_t dimension, size_t maxBins) {
+    if (header.dimension != dimension || (dimension == 2 && header.nBins[2] != 1)) {
+        return false;
+    }
+    size_t nBins = 1;
+    for (int d = 0; d < 3; d++) {
+        if (header.nBins[d] <= 0 || (size_t)header.nBins[d] > maxBins / nBins) {
+            return false;
+        }
+        nBins *= header.nBins[d];
+    }
+    for (int d = 0; d < dimension; d++) {
+        if (!(header.min[d] < header.max[d])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// It creates an empty histogram with the given binning
+TH1* NewMap(const MapHeader& header) {
+    TH1* histogram = nullptr;
+    if (header.dimension == 2) {
+        histogram = new TH2F("gainMap2D", "gainMap2D", header.nBins[0], header.min[0], header.max[0],
+                             header.nBins[1], header.min[1], header.max[1]);
+    } else {
+        histogram = new TH3F("gainMap3D", "gainMap3D", header.nBins[0], header.min[0], header.max[0],
+                             header.nBins[1], header.min[1], header.max[1], header.nBins[2], header.min[2],
+                             header.max[2]);
+    }
+    histogram->SetDirectory(nullptr);
+    return histogram;
+}
+
+/// The bin contents are stored for the bins inside the axis range, with the X index running fastest
+template <typename F>
+void ForEachBin(const MapHeader& header, F function) {
+    for (int k = 1; k <= header.nBins[2]; k++) {
+        for (int j = 1; j <= header.nBins[1]; j++) {
+            for (int i = 1; i <= header.nBins[0]; i++) {
+                function(i, j, header.dimension == 3 ? k : 0);
+            }
+        }
+    }
+}
+}  // namespace
+
+///////////////////////////////////////////////
+/// \brief The gain map may be loaded from a file, in the text or binary formats
+/// written by SaveToText or SaveToBinary, given by the parameter "file".
+///
 void TRestDetectorGainMap::InitFromConfigFile() {
-    // read config from rml section
+    string file = GetParameter("file", "");
+    if (!file.empty()) {
+        string fullName = SearchFile(file);
+        ReadGainFile(fullName.empty() ? file : fullName);
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It reads the gain map from a file written by SaveToText or
+/// SaveToBinary. The format is identified from the file contents.
+///
+Bool_t TRestDetectorGainMap::ReadGainFile(std::string filename) {
+    ifstream file(filename, ios::binary);
+    char magic[sizeof(kBinaryMagic)] = {};
+    file.read(magic, sizeof(magic));
+    if (!file) {
+        RESTError << "TRestDetectorGainMap. Cannot read gain map file: " << filename << RESTendl;
+        return false;
+    }
+    file.close();
+
+    if (memcmp(magic, kBinaryMagic, sizeof(kBinaryMagic)) == 0) {
+        return ReadGainBinary(filename);
+    }
+    return ReadGainText(filename);
+}
+
+///////////////////////////////////////////////
+/// \brief It writes the channel gains and the 2D/3D gain maps to a text file.
+///
+/// The file contains a `channels` line with the number of channels, followed by
+/// one line with the daq id and gain of each channel. Each gain map is written
+/// as a `map2D` or `map3D` line with the number of bins, lower and upper limits
+/// of each axis and the number of entries, followed by the bin contents, one
+/// line for each row of bins along the X axis. The values are written with full
+/// precision, so that the gain map is recovered exactly by ReadGainText.
+///
+Bool_t TRestDetectorGainMap::SaveToText(std::string filename) const {
+    ofstream file(filename);
+    if (!file.is_open()) {
+        RESTError << "TRestDetectorGainMap. Cannot write gain map file: " << filename << RESTendl;
+        return false;
+    }
+    file.precision(numeric_limits<double>::max_digits10);
+
+    file << "# TRestDetectorGainMap" << endl;
+    file << "relative " << (relative ? 1 : 0) << endl;
+    file << "channels " << fChannelGain.size() << endl;
+    for (const auto& [id, gain] : fChannelGain) {
+        file << id << " " << gain << endl;
+    }
+
+    const TH1* maps[2] = {f2DGainMapping, f3DGainMapping};
+    for (int m = 0; m < 2; m++) {
+        if (maps[m] == nullptr) {
+            continue;
+        }
+        MapHeader header;
+        if (!GetMapHeader(maps[m], m + 2, header)) {
+            RESTWarning << "TRestDetectorGainMap. Gain maps with variable bin size are not saved" << RESTendl;
+            continue;
+        }
+
+        file << "map" << header.dimension << "D";
+        for (int d = 0; d < header.dimension; d++) {
+            file << " " << header.nBins[d] << " " << header.min[d] << " " << header.max[d];
+        }
+        file << " " << header.entries << endl;
+
+        ForEachBin(header, [&](int i, int j, int k) {
+            file << maps[m]->GetBinContent(i, j, k) << (i == header.nBins[0] ? "\n" : " ");
+        });
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////
+/// \brief It reads the channel gains and gain maps from a text file written by
+/// SaveToText. The current channel gains and gain maps are replaced, only if the
+/// file is read successfully.
+///
+Bool_t TRestDetectorGainMap::ReadGainText(std::string filename) {
+    ifstream file(filename, ios::ate);
+    if (!file.is_open()) {
+        RESTError << "TRestDetectorGainMap. Cannot read gain map file: " << filename << RESTendl;
+        return false;
+    }
+    // Each bin content takes two characters at least
+    const size_t maxBins = (size_t)file.tellg() / 2;
+    file.seekg(0);
+
+    Bool_t isRelative = relative;
+    map<int, double> channelGain;
+    unique_ptr<TH1> maps[2];
+
+    string key;
+    while (file >> key) {
+        if (key[0] == '#') {
+            getline(file, key);
+        } else if (key == "relative") {
+            Int_t value = 0;
+            file >> value;
+            isRelative = value != 0;
+        } else if (key == "channels") {
+            size_t nChannels = 0;
+            file >> nChannels;
+            for (size_t n = 0; n < nChannels && file; n++) {
+                int id;
+                double gain;
+                file >> id >> gain;
+                channelGain[id] = gain;
+            }
+        } else if (key == "map2D" || key == "map3D") {
+            MapHeader header;
+            header.dimension = key == "map2D" ? 2 : 3;
+            for (int d = 0; d < header.dimension; d++) {
+                file >> header.nBins[d] >> header.min[d] >> header.max[d];
+            }
+            file >> header.entries;
+            if (file) {
+                if (!IsValidMapHeader(header, header.dimension, maxBins)) {
+                    RESTError << "TRestDetectorGainMap. Invalid gain map binning in file: " << filename
+                              << RESTendl;
+                    return false;
+                }
+
+                TH1* histogram = NewMap(header);
+                maps[header.dimension - 2].reset(histogram);
+                ForEachBin(header, [&](int i, int j, int k) {
+                    double content = 0;
+                    file >> content;
+                    histogram->SetBinContent(histogram->GetBin(i, j, k), content);
+                });
+                histogram->SetEntries(header.entries);
+            }
+        } else {
+            RESTError << "TRestDetectorGainMap. Unknown entry in gain map file: " << key << RESTendl;
+            return false;
+        }
+
+        if (!file) {
+            RESTError << "TRestDetectorGainMap. Gain map file is truncated: " << filename << RESTendl;
+            return false;
+        }
+    }
+
+    relative = isRelative;
+    fChannelGain.swap(channelGain);
+    delete f2DGainMapping;
+    f2DGainMapping = (TH2F*)maps[0].release();
+    delete f3DGainMapping;
+    f3DGainMapping = (TH3F*)maps[1].release();
+
+    return true;
+}
+
+///////////////////////////////////////////////
+/// \brief It writes the channel gains and the 2D/3D gain maps to a binary file.
+///
+/// The file is a sequence of fixed size fields in the native byte order, each
+/// section aligned to 8 bytes, so that it can be read with a single read or
+/// mapped in memory:
+/// * The identifier "RESTGAIN", followed by six integers: the byte order mark
+/// 0x01020304, the format version, the relative flag, the number of channels,
+/// the maps found in the file, 1 for the 2D map and 2 for the 3D map, and a
+/// padding zero. Files written on a machine of another byte order are rejected.
+/// * The daq id of each channel, padded to a multiple of 8 bytes, followed by
+/// the gain of each channel.
+/// * For each map, the number of bins of each axis and its dimension, the lower
+/// and upper limits of each axis and the number of entries, followed by the
+/// bin contents, with the X index running fastest.
+///
+Bool_t TRestDetectorGainMap::SaveToBinary(std::string filename) const {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        RESTError << "TRestDetectorGainMap. Cannot write gain map file: " << filename << RESTendl;
+        return false;
+    }
+
+    const TH1* maps[2] = {f2DGainMapping, f3DGainMapping};
+    MapHeader headers[2];
+    Int_t mapFlags = 0;
+    for (int m = 0; m < 2; m++) {
+        if (maps[m] == nullptr) {
+            continue;
+        }
+        if (!GetMapHeader(maps[m], m + 2, headers[m])) {
+            RESTWarning << "TRestDetectorGainMap. Gain maps with variable bin size are not saved" << RESTendl;
+            continue;
+        }
+        mapFlags |= 1 << m;
+    }
+
+    const Int_t nChannels = fChannelGain.size();
+    const Int_t header[6] = {kByteOrderMark, kBinaryVersion, relative ? 1 : 0, nChannels, mapFlags, 0};
+    file.write(kBinaryMagic, sizeof(kBinaryMagic));
+    file.write((const char*)header, sizeof(header));
+
+    vector<Int_t> ids;
+    vector<Double_t> gains;
+    ids.reserve(nChannels + 1);
+    gains.reserve(nChannels);
+    for (const auto& [id, gain] : fChannelGain) {
+        ids.push_back(id);
+        gains.push_back(gain);
+    }
+    if (nChannels % 2 == 1) {
+        ids.push_back(0);
+    }
+    file.write((const char*)ids.data(), ids.size() * sizeof(Int_t));
+    file.write((const char*)gains.data(), gains.size() * sizeof(Double_t));
+
+    vector<Double_t> contents;
+    for (int m = 0; m < 2; m++) {
+        if (!(mapFlags & (1 << m))) {
+            continue;
+        }
+        file.write((const char*)&headers[m], sizeof(MapHeader));
+
+        contents.clear();
+        ForEachBin(headers[m],
+                   [&](int i, int j, int k) { contents.push_back(maps[m]->GetBinContent(i, j, k)); });
+        file.write((const char*)contents.data(), contents.size() * sizeof(Double_t));
+    }
+
+    if (!file) {
+        RESTError << "TRestDetectorGainMap. Error writing gain map file: " << filename << RESTendl;
+        return false;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////
+/// \brief It reads the channel gains and gain maps from a binary file written by
+/// SaveToBinary. The file is read at once, and the current channel gains and gain
+/// maps are replaced, only if the file is read successfully.
+///
+Bool_t TRestDetectorGainMap::ReadGainBinary(std::string filename) {
+    ifstream file(filename, ios::binary | ios::ate);
+    if (!file.is_open()) {
+        RESTError << "TRestDetectorGainMap. Cannot read gain map file: " << filename << RESTendl;
+        return false;
+    }
+    vector<char> buffer(file.tellg());
+    file.seekg(0);
+    file.read(buffer.data(), buffer.size());
+
+    size_t position = 0;
+    auto read = [&](void* destination, size_t bytes) {
+        if (position + bytes > buffer.size()) {
+            return false;
+        }
+        memcpy(destination, buffer.data() + position, bytes);
+        position += bytes;
+        return true;
+    };
+
+    char magic[sizeof(kBinaryMagic)];
+    Int_t header[6];
+    if (!read(magic, sizeof(magic)) || memcmp(magic, kBinaryMagic, sizeof(kBinaryMagic)) != 0 ||
+        !read(header, sizeof(header))) {
+        RESTError << "TRestDetectorGainMap. Not a binary gain map file: " << filename << RESTendl;
+        return false;
+    }
+    if (header[0] != kByteOrderMark) {
+        if (header[0] == kSwappedByteOrderMark) {
+            RESTError << "TRestDetectorGainMap. Gain map file written with another byte order: "
+                      << filename << RESTendl;
+        } else {
+            RESTError << "TRestDetectorGainMap. Not a binary gain map file: " << filename << RESTendl;
+        }
+        return false;
+    }
+    if (header[1] != kBinaryVersion) {
+        RESTError << "TRestDetectorGainMap. Unsupported gain map file version " << header[1] << ": "
+                  << filename << RESTendl;
+        return false;
+    }
+    const Bool_t isRelative = header[2] != 0;
+    const Int_t nChannels = header[3];
+    const Int_t mapFlags = header[4];
+
+    // Each channel takes an id and a gain, so the count is bounded by the remaining bytes
+    const size_t maxChannels = (buffer.size() - position) / (sizeof(Int_t) + sizeof(Double_t));
+    if (nChannels < 0 || (size_t)nChannels > maxChannels) {
+        RESTError << "TRestDetectorGainMap. Gain map file is truncated: " << filename << RESTendl;
+        return false;
+    }
+    vector<Int_t> ids(nChannels + nChannels % 2);
+    vector<Double_t> gains(nChannels);
+    if (!read(ids.data(), ids.size() * sizeof(Int_t)) ||
+        !read(gains.data(), gains.size() * sizeof(Double_t))) {
+        RESTError << "TRestDetectorGainMap. Gain map file is truncated: " << filename << RESTendl;
+        return false;
+    }
+    map<int, double> channelGain;
+    for (int n = 0; n < nChannels; n++) {
+        channelGain.emplace_hint(channelGain.end(), ids[n], gains[n]);
+    }
+
+    unique_ptr<TH1> maps[2];
+    for (int m = 0; m < 2; m++) {
+        if (!(mapFlags & (1 << m))) {
+            continue;
+        }
+        MapHeader mapHeader;
+        if (!read(&mapHeader, sizeof(MapHeader)) ||
+            !IsValidMapHeader(mapHeader, m + 2, (buffer.size() - position) / sizeof(Double_t))) {
+            RESTError << "TRestDetectorGainMap. Gain map file is truncated: " << filename << RESTendl;
+            return false;
+        }
+
+        TH1* histogram = NewMap(mapHeader);
+        maps[m].reset(histogram);
+        ForEachBin(mapHeader, [&](int i, int j, int k) {
+            Double_t content;
+            read(&content, sizeof(Double_t));
+            histogram->SetBinContent(histogram->GetBin(i, j, k), content);
+        });
+        histogram->SetEntries(mapHeader.entries);
+    }
+
+    relative = isRelative;
+    fChannelGain.swap(channelGain);
+    delete f2DGainMapping;
+    f2DGainMapping = (TH2F*)maps[0].release();
+    delete f3DGainMapping;
+    f3DGainMapping = (TH3F*)maps[1].release();
+
+    return true;
+}
+
+///////////////////////////////////////////////
+/// \brief It copies the channel gains into a table indexed by daq id, so that the
+/// gain of a channel is found without a map lookup. The channels without a
+/// recorded gain, up to the largest daq id, are given `defaultGain`.
+///
+void TRestDetectorGainMap::FillChannelGainTable(std::vector<double>& table, double defaultGain) const {
+    table.clear();
+    if (fChannelGain.empty()) {
+        return;
+    }
+
+    // The map is sorted, so the largest daq id is the last key
+    const int maxId = fChannelGain.rbegin()->first;
+    if (maxId < 0) {
+        return;
+    }
+
+    table.assign(maxId + 1, defaultGain);
+    for (const auto& [id, gain] : fChannelGain) {
+        if (id >= 0) {
+            table[id] = gain;
+        }
+    }
 }
 
 void TRestDetectorGainMap::DrawChannelGainMap(TRestDetectorReadoutModule* mod) {
@@ -130,6 +130,22 @@ void TRestDetectorHitmapAnalysisProcess::Initialize() {
     fHitsEvent = nullptr;
 }
 
+///////////////////////////////////////////////
+/// \brief It resolves, once, the names in the ordered list of transformations
+///
+void TRestDetectorHitmapAnalysisProcess::InitProcess() {
+    fTransformationSequence.clear();
+    for (const auto& t : fTransformations) {
+        HitTransformation tr = GetTransformation(t);
+        if (tr.type.empty()) {
+            RESTWarning << "TRestDetectorHitmapAnalysisProcess. Transformation not defined : " << t
+                        << RESTendl;
+            continue;
+        }
+        fTransformationSequence.push_back(tr);
+    }
+}
+
 ///////////////////////////////////////////////
 /// \brief The main processing event function
 ///
@@ -140,10 +156,7 @@ TRestEvent* TRestDetectorHitmapAnalysisProcess::ProcessEvent(TRestEvent* inputEv
 
     TVector3 transformedMean = hitMean;
 
-    for (const auto& t : fTransformations) {
-        HitTransformation tr;
-        tr = GetTransformation(t);
-
+    for (const auto& tr : fTransformationSequence) {
         if (tr.type == "specular") transformedMean = Specular(transformedMean, tr);
         if (tr.type == "rotation") transformedMean = Rotation(transformedMean, tr);
         if (tr.type == "translation") transformedMean = Translation(transformedMean, tr);
@@ -11,6 +11,12 @@
 
 #include "TRestDetectorHits3DReconstructionProcess.h"
 
+#include <array>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
 #include "TFunction.h"
 #include "TLine.h"
 #include "TMarker.h"
@@ -34,6 +40,69 @@ struct regionhit {
     static double dist(const regionhit& h1, const regionhit& h2) {
         return sqrt((h1.x - h2.x) * (h1.x - h2.x) + (h1.y - h2.y) * (h1.y - h2.y));
     }
+
+    // Starting from the most energetic hit, collects the hits **connected** to it, i.e. closer than
+    // PITCH and with lower energy, and adds them as a single merged hit. Repeated until all the hits
+    // are merged. The hits are bucketed in cells of PITCH size, so that only neighbours are compared.
+    static void MergeConnected(const vector<regionhit>& hits, vector<regionhit>& merged) {
+        const int n = hits.size();
+        auto cellkey = [](long cx, long cy) -> unsigned long {
+            return ((unsigned long)cx << 32) ^ ((unsigned long)cy & 0xFFFFFFFF);
+        };
+
+        vector<long> cx(n);
+        vector<long> cy(n);
+        unordered_map<unsigned long, vector<int>> cells;
+        for (int i = 0; i < n; i++) {
+            cx[i] = (long)floor(hits[i].x / PITCH);
+            cy[i] = (long)floor(hits[i].y / PITCH);
+            cells[cellkey(cx[i], cy[i])].push_back(i);
+        }
+
+        vector<int> order(n);
+        iota(order.begin(), order.end(), 0);
+        stable_sort(order.begin(), order.end(), [&](int i, int j) { return hits[i].e > hits[j].e; });
+
+        vector<bool> done(n, false);
+        vector<int> group;
+        for (int seed : order) {
+            if (done[seed]) continue;
+            if (!(hits[seed].e > 0)) break;
+
+            group.assign(1, seed);
+            done[seed] = true;
+            for (size_t g = 0; g < group.size(); g++) {
+                const regionhit& h = hits[group[g]];
+                for (long dx = -1; dx <= 1; dx++) {
+                    for (long dy = -1; dy <= 1; dy++) {
+                        auto cell = cells.find(cellkey(cx[group[g]] + dx, cy[group[g]] + dy));
+                        if (cell == cells.end()) continue;
+                        for (int j : cell->second) {
+                            if (!done[j] && h.e > hits[j].e && dist(h, hits[j]) < PITCH) {
+                                done[j] = true;
+                                group.push_back(j);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // the collection of all the connected hits are merged
+            sort(group.begin(), group.end());
+            regionhit m;
+            for (int i : group) m.add(hits[i]);
+            merged.push_back(m);
+        }
+    }
+};
+
+template <size_t N>
+struct positionhash {
+    size_t operator()(const array<double, N>& p) const {
+        size_t h = 0;
+        for (double v : p) h = h * 1000003 ^ hash<double>()(v);
+        return h;
+    }
 };
 
 struct stripehit {
@@ -116,6 +185,33 @@ struct stripehit {
         }
     }
 
+    // Lists, for each stripe, the other stripes crossing it as IsRectCross, in increasing index
+    // order. The stripes are swept in increasing minimum x, so that only overlapping ones are tested
+    static vector<vector<int>> FindRectCrossings(const vector<stripehit>& stripes) {
+        const int n = stripes.size();
+        vector<int> order(n);
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&](int i, int j) {
+            return min(stripes[i].x1, stripes[i].x2) < min(stripes[j].x1, stripes[j].x2);
+        });
+
+        vector<vector<int>> crossings(n);
+        for (int a = 0; a < n; a++) {
+            const stripehit& s1 = stripes[order[a]];
+            const double maxx = max(s1.x1, s1.x2);
+            for (int b = a + 1; b < n; b++) {
+                const stripehit& s2 = stripes[order[b]];
+                if (min(s2.x1, s2.x2) > maxx) break;
+                if (IsRectCross(s1, s2)) {
+                    crossings[order[a]].push_back(order[b]);
+                    crossings[order[b]].push_back(order[a]);
+                }
+            }
+        }
+        for (auto& c : crossings) sort(c.begin(), c.end());
+        return crossings;
+    }
+
     friend regionhit operator&(const stripehit& s1, const stripehit& s2) {
         if (s1.type * s2.type == XZ * YZ) {
             if (!s1.iszombie() && !s2.iszombie()) {
@@ -161,6 +257,17 @@ struct stripehit {
     }
 };
 
+// a z slice: the distinct z of the hit n, reconstructed with the hits in the window [lo, hi)
+struct zslice {
+    size_t n = 0;
+    size_t lo = 0;
+    size_t hi = 0;
+    size_t nstripes = 0;
+    bool overflow = false;
+    double ambiguity = 0;
+    vector<regionhit> hits;
+};
+
 ClassImp(TRestDetectorHits3DReconstructionProcess)
 
     TRestDetectorHits3DReconstructionProcess::TRestDetectorHits3DReconstructionProcess() {
@@ -204,60 +311,57 @@ TRestEvent* TRestDetectorHits3DReconstructionProcess::ProcessEvent(TRestEvent* i
     // sort with z from small to large
     fInputHitsEvent->Sort();
 
+    TRestHits* hits = fInputHitsEvent->GetHits();
+    const size_t nHits = fInputHitsEvent->GetNumberOfHits();
+    vector<double> zs(nHits);
+    for (size_t n = 0; n < nHits; n++) zs[n] = fInputHitsEvent->GetZ(n);
+
+    // sweep over the distinct z, keeping the window of hits closer than 2*fZRange
+    vector<zslice> slices;
     double lastz = 0;
-    double totalambiguity = 0;
-    double Nlayers = 0;
-    for (unsigned int n = 0; n < fInputHitsEvent->GetNumberOfHits(); n++) {
-        double z = fInputHitsEvent->GetZ(n);
+    size_t lo = 0;
+    size_t hi = 0;
+    for (size_t n = 0; n < nHits; n++) {
+        double z = zs[n];
         if (z == lastz) continue;
 
         lastz = z;
+        while (lo < nHits && z - zs[lo] >= fZRange * 2) lo++;
+        while (hi < nHits && zs[hi] - z < fZRange * 2) hi++;
+
+        zslice slice;
+        slice.n = n;
+        slice.lo = lo;
+        slice.hi = hi;
+        slices.push_back(slice);
+    }
 
-        // find the hits near this z slice
-        map<int, double> ids;  //[id, weight]
-        ids[n] = 1;
-        for (int i = n - 1; i >= 0; i--) {
-            if (abs(fInputHitsEvent->GetZ(i) - z) < fZRange * 2) {
-                ids[i] = TMath::Gaus(abs(fInputHitsEvent->GetZ(i) - z), 0, fZRange);
-            } else {
-                break;
-            }
-        }
-        for (unsigned int i = n + 1; i < fInputHitsEvent->GetNumberOfHits(); i++) {
-            if (abs(fInputHitsEvent->GetZ(i) - z) < fZRange * 2) {
-                ids[i] = TMath::Gaus(abs(fInputHitsEvent->GetZ(i) - z), 0, fZRange);
-            } else {
-                break;
-            }
-        }
+    auto reconstruct = [&](zslice& slice) {
+        const size_t n = slice.n;
+        const double z = zs[n];
 
-        // extract stripe hits
+        // extract stripe hits in the window, merging the ones at the same position
         vector<stripehit> stripehits;
-        for (auto i : ids) {
-            stripehit h = stripehit(fInputHitsEvent->GetHits(), i.first);
-            h.e *= i.second;
+        unordered_map<array<double, 4>, int, positionhash<4>> stripeids;
+        for (size_t i = min(slice.lo, n); i < max(slice.hi, n + 1); i++) {
+            if (i != n && abs(zs[i] - z) >= fZRange * 2) continue;
+
+            stripehit h = stripehit(hits, i);
+            h.e *= i == n ? 1 : TMath::Gaus(abs(zs[i] - z), 0, fZRange);
             if (!h.iszombie()) {
-                if (stripehits.size() > 0) {
-                    for (unsigned int k = 0; k < stripehits.size(); k++) {
-                        stripehit& _h = stripehits[k];
-                        if (_h.x1 == h.x1 && _h.x2 == h.x2 && _h.y1 == h.y1 && _h.y2 == h.y2) {
-                            _h.e += h.e;
-                            break;
-                        } else if (k == stripehits.size() - 1) {
-                            stripehits.push_back(h);
-                        }
-                    }
-                } else {
+                auto id = stripeids.emplace(array<double, 4>{h.x1, h.x2, h.y1, h.y2}, stripehits.size());
+                if (id.second) {
                     stripehits.push_back(h);
+                } else {
+                    stripehits[id.first->second].e += h.e;
                 }
             }
         }
 
-        if (stripehits.size() > 50) {
-            RESTWarning << "(TRestDetectorHits3DReconstructionProcess) event id: " << fInputHitsEvent->GetID()
-                        << ", z: " << z << ", bad frame, too much hits! (" << stripehits.size() << ")"
-                        << RESTendl;
-            continue;
+        slice.nstripes = stripehits.size();
+        if (fMaxStripeHits > 0 && (int)stripehits.size() > fMaxStripeHits) {
+            slice.overflow = true;
+            return;
         }
 
         if (fVerboseLevel >= TRestStringOutput::REST_Verbose_Level::REST_Extreme) {
@@ -268,37 +372,27 @@ TRestEvent* TRestDetectorHits3DReconstructionProcess::ProcessEvent(TRestEvent* i
             cout << endl;
         }
 
+        vector<vector<int>> crossings = stripehit::FindRectCrossings(stripehits);
+
         // find all the crossing points of stripe hits
         vector<regionhit> regionhits;
+        unordered_map<array<double, 2>, int, positionhash<2>> regionids;
         double layerambiguity = 0;
         set<int> ambcalculatedstripes;
         for (unsigned int i = 0; i < stripehits.size(); i++) {
-            vector<int> crossedids;
+            const vector<int>& crossedids = crossings[i];
             double crossedsumenergy = 0;
-            for (unsigned int j = 0; j < stripehits.size(); j++) {
-                if (i == j) continue;
-                if (stripehit::IsRectCross(stripehits[i], stripehits[j])) {
-                    crossedids.push_back(j);
-                    crossedsumenergy += stripehits[j].e;
-                }
-            }
+            for (int id : crossedids) crossedsumenergy += stripehits[id].e;
 
             for (int id : crossedids) {
                 regionhit rh = stripehits[i] & stripehits[id];
                 rh.e = stripehits[i].e * stripehits[id].e / crossedsumenergy;
 
-                if (regionhits.size() > 0) {
-                    for (unsigned int k = 0; k < regionhits.size(); k++) {
-                        regionhit& _rh = regionhits[k];
-                        if (_rh.x == rh.x && _rh.y == rh.y) {
-                            _rh.e += rh.e;
-                            break;
-                        } else if (k == regionhits.size() - 1) {
-                            regionhits.push_back(rh);
-                        }
-                    }
-                } else {
+                auto rid = regionids.emplace(array<double, 2>{rh.x, rh.y}, regionhits.size());
+                if (rid.second) {
                     regionhits.push_back(rh);
+                } else {
+                    regionhits[rid.first->second].e += rh.e;
                 }
             }
 
@@ -310,13 +404,7 @@ TRestEvent* TRestDetectorHits3DReconstructionProcess::ProcessEvent(TRestEvent* i
 
                 auto line = stripehits[i];
                 auto newline = stripehits[crossedids[0]];
-                vector<int> crossedids_newline;
-                for (unsigned int j = 0; j < stripehits.size(); j++) {
-                    if (j == (unsigned int)crossedids[0]) continue;
-                    if (stripehit::IsRectCross(stripehits[j], newline)) {
-                        crossedids_newline.push_back(j);
-                    }
-                }
+                const vector<int>& crossedids_newline = crossings[crossedids[0]];
                 for (int id : crossedids_newline) {
                     ambcalculatedstripes.insert(id);
                 }
@@ -417,64 +505,14 @@ TRestEvent* TRestDetectorHits3DReconstructionProcess::ProcessEvent(TRestEvent* i
             }
         }
         // cout << "z: " << z << ", amb: " << layerambiguity << endl;
-        totalambiguity += layerambiguity;
+        slice.ambiguity = layerambiguity;
 
         // merge the cossing points
-        vector<regionhit> regionhits_merged;
-        set<int> mergeflag_all;
-        while (mergeflag_all.size() < regionhits.size()) {
-            // find the initial point(with max energy)
-            double max = 0;
-            int maxposition;
-            for (unsigned int i = 0; i < regionhits.size(); i++) {
-                if (mergeflag_all.count(i) == 0) {
-                    if (regionhits[i].e > max) {
-                        max = regionhits[i].e;
-                        maxposition = i;
-                    }
-                }
-            }
-            set<int> mergeflag;
-            mergeflag.insert(maxposition);
-
-            // loop over regionhits to find any hits that is **connected** to the initial point
-            for (auto _i = mergeflag.begin(); _i != mergeflag.end();) {
-                int i = *_i;
-
-                // cout << i << ": ";
-                // for (auto __i : mergeflag) cout << __i << " ";
-                // cout << endl;
-
-                bool inserted = false;
-                for (unsigned int j = 0; j < regionhits.size(); j++) {
-                    if (regionhit::dist(regionhits[i], regionhits[j]) < PITCH &&
-                        regionhits[i].e > regionhits[j].e && mergeflag_all.count(j) == 0) {
-                        auto insertresult = mergeflag.insert(j);
-                        inserted += insertresult.second;
-                    }
-                }
-                // if inserted, we go back to the begin incase it is inserted to the former
-                if (inserted)
-                    _i = mergeflag.begin();
-                else
-                    _i++;
-            }
-
-            // cout << z << " " << regionhits.size() << " " << mergeflag.size() << endl;
-            // cout << endl;
-
-            // the collection of all the connected hits are merged
-            regionhit h;
-            for (auto i : mergeflag) {
-                mergeflag_all.insert(i);
-                h.add(regionhits[i]);
-            }
-            regionhits_merged.push_back(h);
-        }
-        if (regionhits_merged.size() > 0) Nlayers++;
+        vector<regionhit>& regionhits_merged = slice.hits;
+        regionhit::MergeConnected(regionhits, regionhits_merged);
 
         if (fDraw && (layerambiguity > fDrawThres)) {
-            if (regionhits.size() == 0) continue;
+            if (regionhits.size() == 0) return;
             double maxenergyofregionhits =
                 (*min_element(regionhits.begin(), regionhits.end(),
                               [](const regionhit& h1, const regionhit& h2) -> bool { return h1.e > h2.e; }))
@@ -514,9 +552,40 @@ TRestEvent* TRestDetectorHits3DReconstructionProcess::ProcessEvent(TRestEvent* i
                 delete m;
             }
         }
+    };
+
+    // the z slices are independent, they can be reconstructed in parallel
+    int nThreads = fSliceThreads > 0 ? fSliceThreads : (int)std::thread::hardware_concurrency();
+    if (fDraw || fVerboseLevel >= TRestStringOutput::REST_Verbose_Level::REST_Debug) nThreads = 1;
+    if (nThreads <= 1 || slices.size() < 2) {
+        for (auto& slice : slices) reconstruct(slice);
+    } else {
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t s = next++; s < slices.size(); s = next++) reconstruct(slices[s]);
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < std::min(nThreads, (int)slices.size()); t++) threads.emplace_back(worker);
+        for (auto& thread : threads) thread.join();
+    }
+
+    double totalambiguity = 0;
+    double Nlayers = 0;
+    for (auto& slice : slices) {
+        const double z = zs[slice.n];
+        if (slice.overflow) {
+            RESTWarning << "(TRestDetectorHits3DReconstructionProcess) event id: " << fInputHitsEvent->GetID()
+                        << ", z: " << z << ", bad frame, too much hits! (" << slice.nstripes << ")"
+                        << RESTendl;
+            continue;
+        }
+
+        totalambiguity += slice.ambiguity;
+        if (slice.hits.size() > 0) Nlayers++;
 
         // for (auto rh : regionhits) {
-        for (auto rh : regionhits_merged) {
+        for (auto rh : slice.hits) {
             fOutputHitsEvent->AddHit(rh.x, rh.y, z, rh.e, 0, XYZ);
         }
     }
@@ -530,7 +599,9 @@ TRestEvent* TRestDetectorHits3DReconstructionProcess::ProcessEvent(TRestEvent* i
         }
     }
 
-    SetObservableValue("MeanAmbiguity", totalambiguity / Nlayers);
+    fMeanAmbiguity = totalambiguity / Nlayers;
+    fNLayers = Nlayers;
+    SetObservableValue("MeanAmbiguity", fMeanAmbiguity);
     SetObservableValue("DiffRecon", numeric_limits<double>::quiet_NaN());
     if (fCompareProc != nullptr && fOutputHitsEvent->GetNumberOfHits() > 0 &&
         (fObservablesDefined.count("DiffRecon") != 0 || fDynamicObs)) {
@@ -606,6 +677,8 @@ void TRestDetectorHits3DReconstructionProcess::InitFromConfigFile() {
     if (fDraw) fSingleThreadOnly = true;
     fDrawThres = StringToDouble(GetParameter("drawThreshold", "3"));
     fDoEnergyScaling = StringToBool(GetParameter("scaleE", "true"));
+    fMaxStripeHits = StringToInteger(GetParameter("maxStripeHits", "50"));
+    fSliceThreads = StringToInteger(GetParameter("sliceThreads", "1"));
 
     fCanvasSize = StringTo2DVector(GetParameter("canvasSize", "(800,600)"));
 }
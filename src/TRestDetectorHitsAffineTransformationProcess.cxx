@@ -0,0 +1,262 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// TRestDetectorHitsAffineTransformationProcess applies, in a single pass,
+/// the combined effect of a sequence of TRestDetectorHitsRotationProcess,
+/// TRestDetectorHitsTranslationProcess, TRestDetectorHitsSpecularProcess and
+/// TRestDetectorHitsNormalizationProcess.
+///
+/// The transformations are defined as elements inside the process section,
+/// and they are applied in the same order as they appear. Each element takes
+/// the same parameters, with the same defaults, as the process it replaces:
+///
+/// \code
+///    <addProcess type="TRestDetectorHitsAffineTransformationProcess" name="orient"
+///                title="Reflection, rotation and translation of the hits">
+///        <specular normal="(0,1,0)" position="(0,0,0)mm" />
+///        <rotation axis="(0,0,1)" center="(0,0,0)mm" angle="45degrees" />
+///        <translation translation="(5,5,0)mm" />
+///        <normalization normFactor="0.5" />
+///    </addProcess>
+/// \endcode
+///
+/// At the configuration, the whole sequence is combined into a single affine
+/// transformation, x' = M x + t, stored as a 3x4 matrix, together with the
+/// product of the normalization factors. Each event is then transformed in
+/// place, computing the new position of each hit with a single matrix product
+/// instead of copying the event once for each transformation.
+///
+/// As in the processes it replaces, only the positions of the hits of type XYZ
+/// are transformed, while the energy normalization applies to all the hits.
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October First implementation of TRestDetectorHitsAffineTransformationProcess.
+///
+/// \class TRestDetectorHitsAffineTransformationProcess
+///
+/// <hr>
+///
+#include "TRestDetectorHitsAffineTransformationProcess.h"
+
+#include <TRotation.h>
+
+using namespace std;
+
+ClassImp(TRestDetectorHitsAffineTransformationProcess);
+
+TRestDetectorHitsAffineTransformationProcess::TRestDetectorHitsAffineTransformationProcess() {
+    Initialize();
+}
+
+///////////////////////////////////////////////
+/// \brief Constructor loading data from a config file
+///
+/// If no configuration path is defined using TRestMetadata::SetConfigFilePath
+/// the path to the config file must be specified using full path, absolute or
+/// relative.
+///
+/// The default behaviour is that the config file must be specified with
+/// full path, absolute or relative.
+///
+/// \param configFilename A const char* giving the path to an RML file.
+///
+TRestDetectorHitsAffineTransformationProcess::TRestDetectorHitsAffineTransformationProcess(
+    const char* configFilename) {
+    Initialize();
+    LoadConfigFromFile(configFilename);
+}
+
+TRestDetectorHitsAffineTransformationProcess::~TRestDetectorHitsAffineTransformationProcess() {}
+
+void TRestDetectorHitsAffineTransformationProcess::Initialize() {
+    SetSectionName(this->ClassName());
+    SetLibraryVersion(LIBRARY_VERSION);
+
+    fHitsEvent = nullptr;
+}
+
+TRestEvent* TRestDetectorHitsAffineTransformationProcess::ProcessEvent(TRestEvent* inputEvent) {
+    fHitsEvent = (TRestDetectorHitsEvent*)inputEvent;
+
+    TRestHits* hits = fHitsEvent->GetHits();
+    const Double_t* m = fMatrix.data();
+
+    // The total energy of TRestHits is only updated when hits are added, thus a
+    // normalization requires to rebuild the hits
+    if (fEnergyScale != 1) {
+        const size_t nHits = hits->GetNumberOfHits();
+        vector<TVector3> positions(nHits);
+        vector<Double_t> energies(nHits);
+        vector<Double_t> times(nHits);
+        vector<REST_HitType> types(nHits);
+        for (size_t n = 0; n < nHits; n++) {
+            positions[n] = {hits->GetX(n), hits->GetY(n), hits->GetZ(n)};
+            energies[n] = hits->GetEnergy(n);
+            times[n] = hits->GetTime(n);
+            types[n] = hits->GetType(n);
+        }
+
+        hits->RemoveHits();
+        for (size_t n = 0; n < nHits; n++) {
+            if (types[n] == XYZ) positions[n] = Transform(positions[n]);
+            hits->AddHit(positions[n], energies[n] * fEnergyScale, times[n], types[n]);
+        }
+        return fHitsEvent;
+    }
+
+    size_t n = 0;
+    for (auto hit : *hits) {
+        // veto hits won't be transformed because they are not XYZ
+        if (hits->GetType(n++) != XYZ) continue;
+
+        const Double_t x = hit.x();
+        const Double_t y = hit.y();
+        const Double_t z = hit.z();
+        hit.x() = m[0] * x + m[1] * y + m[2] * z + m[3];
+        hit.y() = m[4] * x + m[5] * y + m[6] * z + m[7];
+        hit.z() = m[8] * x + m[9] * y + m[10] * z + m[11];
+    }
+
+    return fHitsEvent;
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the given position after the combined transformation
+///
+TVector3 TRestDetectorHitsAffineTransformationProcess::Transform(const TVector3& position) const {
+    const Double_t* m = fMatrix.data();
+    const Double_t x = position.X();
+    const Double_t y = position.Y();
+    const Double_t z = position.Z();
+    return {m[0] * x + m[1] * y + m[2] * z + m[3], m[4] * x + m[5] * y + m[6] * z + m[7],
+            m[8] * x + m[9] * y + m[10] * z + m[11]};
+}
+
+///////////////////////////////////////////////
+/// \brief It applies the transformation x' = a x + b after the current one
+///
+/// \param a A row-major 3x3 matrix.
+/// \param b The translation applied after the matrix product.
+///
+void TRestDetectorHitsAffineTransformationProcess::AppendLinear(const Double_t* a, const TVector3& b) {
+    const Double_t t[3] = {b.X(), b.Y(), b.Z()};
+
+    vector<Double_t> result(12, 0);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 4; j++) {
+            for (int k = 0; k < 3; k++) result[4 * i + j] += a[3 * i + k] * fMatrix[4 * k + j];
+        }
+        result[4 * i + 3] += t[i];
+    }
+
+    fMatrix = result;
+    fNumberOfSteps++;
+}
+
+///////////////////////////////////////////////
+/// \brief It adds a rotation of `angle` around `axis`, with its center at `center`, as
+/// TRestDetectorHitsRotationProcess
+///
+void TRestDetectorHitsAffineTransformationProcess::AddRotation(Double_t angle, const TVector3& axis,
+                                                               const TVector3& center) {
+    TRotation rotation;
+    rotation.Rotate(angle, axis);
+
+    const Double_t a[9] = {rotation.XX(), rotation.XY(), rotation.XZ(), rotation.YX(), rotation.YY(),
+                           rotation.YZ(), rotation.ZX(), rotation.ZY(), rotation.ZZ()};
+    AppendLinear(a, center - rotation * center);
+}
+
+///////////////////////////////////////////////
+/// \brief It adds a translation, as TRestDetectorHitsTranslationProcess
+///
+void TRestDetectorHitsAffineTransformationProcess::AddTranslation(const TVector3& translation) {
+    const Double_t a[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+    AppendLinear(a, translation);
+}
+
+///////////////////////////////////////////////
+/// \brief It adds a reflection on the plane with the given `normal` containing `position`, as
+/// TRestDetectorHitsSpecularProcess
+///
+void TRestDetectorHitsAffineTransformationProcess::AddSpecular(const TVector3& normal,
+                                                               const TVector3& position) {
+    const TVector3 u = normal.Unit();
+    const Double_t a[9] = {1 - 2 * u.X() * u.X(), -2 * u.X() * u.Y(),    -2 * u.X() * u.Z(),
+                           -2 * u.Y() * u.X(),    1 - 2 * u.Y() * u.Y(), -2 * u.Y() * u.Z(),
+                           -2 * u.Z() * u.X(),    -2 * u.Z() * u.Y(),    1 - 2 * u.Z() * u.Z()};
+    AppendLinear(a, 2 * position.Dot(u) * u);
+}
+
+///////////////////////////////////////////////
+/// \brief It adds an energy normalization, as TRestDetectorHitsNormalizationProcess
+///
+void TRestDetectorHitsAffineTransformationProcess::AddNormalization(Double_t factor) {
+    fEnergyScale *= factor;
+    fNumberOfSteps++;
+}
+
+void TRestDetectorHitsAffineTransformationProcess::InitFromConfigFile() {
+    TRestEventProcess::InitFromConfigFile();
+
+    fMatrix = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0};
+    fEnergyScale = 1;
+    fNumberOfSteps = 0;
+
+    TiXmlElement* ele = fElement->FirstChildElement();
+    while (ele != nullptr) {
+        const string type = ele->Value();
+        if (type == "rotation") {
+            AddRotation(GetDblParameterWithUnits("angle", ele, 0),
+                        Get3DVectorParameterWithUnits("axis", ele, {0, 0, 1}),
+                        Get3DVectorParameterWithUnits("center", ele, {0, 0, 0}));
+        } else if (type == "translation") {
+            AddTranslation(Get3DVectorParameterWithUnits("translation", ele, {0, 0, 1}));
+        } else if (type == "specular") {
+            AddSpecular(Get3DVectorParameterWithUnits("normal", ele, {0, 0, 1}),
+                        Get3DVectorParameterWithUnits("position", ele, {0, 0, 1}));
+        } else if (type == "normalization") {
+            AddNormalization(StringToDouble(GetParameter("normFactor", ele, "1")));
+        }
+        ele = ele->NextSiblingElement();
+    }
+}
+
+void TRestDetectorHitsAffineTransformationProcess::PrintMetadata() {
+    BeginPrintProcess();
+
+    RESTMetadata << " - Number of combined transformations : " << fNumberOfSteps << RESTendl;
+    RESTMetadata << " - Affine matrix : " << RESTendl;
+    for (int i = 0; i < 3; i++) {
+        RESTMetadata << "   ( " << fMatrix[4 * i] << ", " << fMatrix[4 * i + 1] << ", " << fMatrix[4 * i + 2]
+                     << " | " << fMatrix[4 * i + 3] << " )" << RESTendl;
+    }
+    RESTMetadata << " - Energy scale : " << fEnergyScale << RESTendl;
+
+    EndPrintProcess();
+}
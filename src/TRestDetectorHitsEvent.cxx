@@ -110,6 +110,26 @@ void TRestDetectorHitsEvent::AddHit(const TVector3& position, Double_t energy, D
     fHits->AddHit(position, energy, time, type);
 }
 
+namespace {
+// TRestHits does not expose the reservation of its hit arrays, which are protected members
+struct HitsStorage : public TRestHits {
+    static void Reserve(TRestHits* hits, size_t nHits) {
+        (hits->*&HitsStorage::fX).reserve(nHits);
+        (hits->*&HitsStorage::fY).reserve(nHits);
+        (hits->*&HitsStorage::fZ).reserve(nHits);
+        (hits->*&HitsStorage::fTime).reserve(nHits);
+        (hits->*&HitsStorage::fEnergy).reserve(nHits);
+        (hits->*&HitsStorage::fType).reserve(nHits);
+    }
+};
+}  // namespace
+
+///////////////////////////////////////////////
+/// rief Reserves the storage of `nHits` hits, so that adding up to `nHits` hits
+/// to this event does not reallocate the hit arrays.
+///
+void TRestDetectorHitsEvent::Reserve(size_t nHits) { HitsStorage::Reserve(fHits, nHits); }
+
 ///////////////////////////////////////////////
 /// \brief Removes all hits from this event, and clears all auxiliar variables.
 ///
@@ -0,0 +1,256 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// This process multiplies the energy of each hit by the gain correction
+/// found at its position in the 2D (XY) and 3D (XYZ) gain maps of the
+/// TRestDetectorGainMap available to TRestRun. The 2D gain map can be produced
+/// with TRestDetectorPositionMappingProcess in create mode. The 3D gain map is
+/// only used if it contains entries.
+///
+/// The bin contents of each map are copied at InitProcess into a dense table,
+/// and the bin of each hit is obtained directly from the axis limits, without
+/// calling TAxis::FindBin. Maps with a variable bin size are accessed through
+/// the histogram. If the parameter "interpolate" is true, the default, the gain
+/// is interpolated linearly between the centers of the neighbour bins, as done
+/// by TH2::Interpolate. Otherwise the content of the bin is used.
+///
+/// Hits outside the map are given the gain of the closest bin. Hits without a
+/// coordinate required by the map, as the XZ and YZ hits for the 2D map, are
+/// not corrected by that map.
+///
+/// An example of the process definition:
+/// \code
+/// <addProcess type="TRestDetectorHitsGainCorrectionProcess" name="hitsGainCorr" value="ON">
+///     <parameter name="interpolate" value="true" />
+/// </addProcess>
+/// \endcode
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October First implementation of TRestDetectorHitsGainCorrectionProcess.
+///
+/// \class      TRestDetectorHitsGainCorrectionProcess
+///
+/// <hr>
+///
+
+#include "TRestDetectorHitsGainCorrectionProcess.h"
+
+#include <TMath.h>
+
+#include <cmath>
+
+using namespace std;
+
+ClassImp(TRestDetectorHitsGainCorrectionProcess);
+
+///////////////////////////////////////////////
+/// \brief Default constructor
+///
+TRestDetectorHitsGainCorrectionProcess::TRestDetectorHitsGainCorrectionProcess() { Initialize(); }
+
+///////////////////////////////////////////////
+/// \brief Constructor loading data from a config file
+///
+/// \param configFilename A const char* giving the path to an RML file.
+///
+TRestDetectorHitsGainCorrectionProcess::TRestDetectorHitsGainCorrectionProcess(const char* configFilename) {
+    Initialize();
+
+    LoadConfigFromFile(configFilename);
+}
+
+///////////////////////////////////////////////
+/// \brief Default destructor
+///
+TRestDetectorHitsGainCorrectionProcess::~TRestDetectorHitsGainCorrectionProcess() { delete fOutputEvent; }
+
+///////////////////////////////////////////////
+/// \brief Function to initialize input/output event members and define the section name
+///
+void TRestDetectorHitsGainCorrectionProcess::Initialize() {
+    SetSectionName(this->ClassName());
+    SetLibraryVersion(LIBRARY_VERSION);
+
+    fInputEvent = nullptr;
+    fOutputEvent = new TRestDetectorHitsEvent();
+    fCalib = nullptr;
+}
+
+///////////////////////////////////////////////
+/// \brief Process initialization. The gain maps are copied into dense tables.
+///
+void TRestDetectorHitsGainCorrectionProcess::InitProcess() {
+    if (fCalib == nullptr) fCalib = GetMetadata<TRestDetectorGainMap>();
+    if (fCalib == nullptr) {
+        RESTError << "You must set a TRestDetectorGainMap metadata object to apply gain correction!"
+                  << RESTendl;
+        abort();
+    }
+
+    BuildGrid(f2DGrid, fCalib->f2DGainMapping, 2);
+
+    TH1* map3D = fCalib->f3DGainMapping;
+    BuildGrid(f3DGrid, (map3D != nullptr && map3D->GetEntries() > 0) ? map3D : nullptr, 3);
+
+    if (f2DGrid.dimension == 0 && f3DGrid.dimension == 0) {
+        RESTWarning << "TRestDetectorHitsGainCorrectionProcess. The gain map does not contain 2D or 3D maps"
+                    << RESTendl;
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It copies the bin contents of a gain map histogram into `grid`,
+/// together with the axis limits required to find the bin of a position.
+///
+void TRestDetectorHitsGainCorrectionProcess::BuildGrid(GainGrid& grid, TH1* histogram, Int_t dimension) {
+    grid = GainGrid();
+    if (histogram == nullptr) {
+        return;
+    }
+
+    grid.dimension = dimension;
+
+    const TAxis* axes[3] = {histogram->GetXaxis(), histogram->GetYaxis(), histogram->GetZaxis()};
+    for (int d = 0; d < dimension; d++) {
+        if (axes[d]->IsVariableBinSize()) {
+            grid.histogram = histogram;
+            return;
+        }
+        grid.nBins[d] = axes[d]->GetNbins();
+        grid.min[d] = axes[d]->GetXmin();
+        grid.invWidth[d] = grid.nBins[d] / (axes[d]->GetXmax() - axes[d]->GetXmin());
+    }
+
+    grid.gain.resize(grid.nBins[0] * grid.nBins[1] * grid.nBins[2]);
+    for (int k = 0; k < grid.nBins[2]; k++) {
+        for (int j = 0; j < grid.nBins[1]; j++) {
+            for (int i = 0; i < grid.nBins[0]; i++) {
+                const Int_t binZ = dimension == 3 ? k + 1 : 0;
+                grid.gain[(k * grid.nBins[1] + j) * grid.nBins[0] + i] =
+                    histogram->GetBinContent(i + 1, j + 1, binZ);
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the gain of the given map at a position. It returns 1 if
+/// the map is not defined or a required coordinate is not a number.
+///
+Double_t TRestDetectorHitsGainCorrectionProcess::GetGain(const GainGrid& grid, Double_t x, Double_t y,
+                                                         Double_t z) const {
+    const Double_t position[3] = {x, y, z};
+    for (int d = 0; d < grid.dimension; d++) {
+        if (TMath::IsNaN(position[d])) {
+            return 1;
+        }
+    }
+
+    if (grid.dimension == 0) {
+        return 1;
+    }
+
+    if (grid.histogram != nullptr) {
+        // The position is moved inside the map, since TH1::Interpolate does not extrapolate
+        TH1* histogram = grid.histogram;
+        const TAxis* axes[3] = {histogram->GetXaxis(), histogram->GetYaxis(), histogram->GetZaxis()};
+        Double_t inside[3] = {x, y, z};
+        for (int d = 0; d < grid.dimension; d++) {
+            const TAxis* axis = axes[d];
+            const Double_t low = fInterpolate ? axis->GetBinCenter(1) : axis->GetXmin();
+            const Double_t high = fInterpolate ? axis->GetBinCenter(axis->GetNbins()) : axis->GetXmax();
+            inside[d] = TMath::Max(low, TMath::Min(inside[d], std::nextafter(high, low)));
+        }
+        if (fInterpolate) {
+            return grid.dimension == 2 ? histogram->Interpolate(inside[0], inside[1])
+                                       : histogram->Interpolate(inside[0], inside[1], inside[2]);
+        }
+        return histogram->GetBinContent(histogram->FindFixBin(inside[0], inside[1], inside[2]));
+    }
+
+    if (!fInterpolate) {
+        Int_t index = 0;
+        for (int d = grid.dimension - 1; d >= 0; d--) {
+            const Int_t bin = (Int_t)TMath::Floor((position[d] - grid.min[d]) * grid.invWidth[d]);
+            index = index * grid.nBins[d] + TMath::Min(TMath::Max(bin, 0), grid.nBins[d] - 1);
+        }
+        return grid.gain[index];
+    }
+
+    // Linear interpolation between the bin centers, constant beyond the outer bin centers
+    Int_t low[3] = {0, 0, 0};
+    Int_t high[3] = {0, 0, 0};
+    Double_t weight[3] = {0, 0, 0};
+    for (int d = 0; d < grid.dimension; d++) {
+        const Double_t u = (position[d] - grid.min[d]) * grid.invWidth[d] - 0.5;
+        const Int_t bin = (Int_t)TMath::Floor(u);
+        if (bin < 0) {
+            low[d] = high[d] = 0;
+        } else if (bin >= grid.nBins[d] - 1) {
+            low[d] = high[d] = grid.nBins[d] - 1;
+        } else {
+            low[d] = bin;
+            high[d] = bin + 1;
+            weight[d] = u - bin;
+        }
+    }
+
+    Double_t gain = 0;
+    for (int corner = 0; corner < (1 << grid.dimension); corner++) {
+        Double_t cornerWeight = 1;
+        Int_t index = 0;
+        for (int d = grid.dimension - 1; d >= 0; d--) {
+            const Bool_t upper = (corner >> d) & 1;
+            cornerWeight *= upper ? weight[d] : 1 - weight[d];
+            index = index * grid.nBins[d] + (upper ? high[d] : low[d]);
+        }
+        gain += cornerWeight * grid.gain[index];
+    }
+    return gain;
+}
+
+///////////////////////////////////////////////
+/// \brief The main processing event function
+///
+TRestEvent* TRestDetectorHitsGainCorrectionProcess::ProcessEvent(TRestEvent* inputEvent) {
+    fInputEvent = (TRestDetectorHitsEvent*)inputEvent;
+    fOutputEvent->SetEventInfo(fInputEvent);
+
+    for (unsigned int hit = 0; hit < fInputEvent->GetNumberOfHits(); hit++) {
+        const Double_t x = fInputEvent->GetX(hit);
+        const Double_t y = fInputEvent->GetY(hit);
+        const Double_t z = fInputEvent->GetZ(hit);
+
+        const Double_t gain = GetGain(f2DGrid, x, y, z) * GetGain(f3DGrid, x, y, z);
+
+        fOutputEvent->AddHit(x, y, z, fInputEvent->GetEnergy(hit) * gain, fInputEvent->GetTime(hit),
+                             fInputEvent->GetType(hit));
+    }
+
+    return fOutputEvent;
+}
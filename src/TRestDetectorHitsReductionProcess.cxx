@@ -13,6 +13,9 @@
 
 #include "TRestDetectorHitsReductionProcess.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace std;
 
 ClassImp(TRestDetectorHitsReductionProcess);
@@ -64,17 +67,7 @@ TRestEvent* TRestDetectorHitsReductionProcess::ProcessEvent(TRestEvent* inputEve
     Double_t distance = fStartingDistance;
     while (distance < fMinimumDistance || hits->GetNumberOfHits() > fMaxNodes) {
         Bool_t merged = true;
-        while (merged) {
-            merged = false;
-            for (unsigned int i = 0; i < hits->GetNumberOfHits(); i++) {
-                for (unsigned int j = i + 1; j < hits->GetNumberOfHits(); j++) {
-                    if (hits->GetDistance2(i, j) < distance * distance) {
-                        hits->MergeHits(i, j);
-                        merged = true;
-                    }
-                }
-            }
-        }
+        while (merged) merged = MergePass(hits, distance);
         distance *= fDistanceFactor;
     }
 
@@ -99,6 +92,150 @@ TRestEvent* TRestDetectorHitsReductionProcess::ProcessEvent(TRestEvent* inputEve
     return fOutputHitsEvent;
 }
 
+///////////////////////////////////////////////
+/// \brief It merges, in a single pass, the hits closer than the given distance.
+///
+/// As in the all-pairs merging, each hit that was not merged yet absorbs, in
+/// increasing index order, the following hits closer than the distance to its
+/// running energy weighted centroid, as TRestHits::MergeHits does. The merged
+/// hits keep the order of the hit that absorbed them, and they are rebuilt once
+/// at the end of the pass. The hits that absorbed no other hit keep their position
+/// and time, as well as the clusters without energy. It returns true if any hit
+/// was merged.
+///
+/// The hits are bucketed in a grid with a cell size equal to the merging distance,
+/// and only the hits found in the cells next to the absorbing hit are compared.
+/// Only the coordinates defined by the type of all the hits are used to build the
+/// grid. A centroid that moves away from those cells is merged with further hits
+/// in the following passes.
+///
+Bool_t TRestDetectorHitsReductionProcess::MergePass(TRestHits* hits, Double_t distance) {
+    const Int_t nHits = hits->GetNumberOfHits();
+    if (nHits < 2) return false;
+
+    Bool_t useAxis[3] = {true, true, true};
+    fTypes.resize(nHits);
+    for (Int_t n = 0; n < nHits; n++) {
+        fTypes[n] = hits->GetType(n);
+        const Int_t type = fTypes[n];
+        if (type % X != 0) useAxis[0] = false;
+        if (type % Y != 0) useAxis[1] = false;
+        if (type % Z != 0) useAxis[2] = false;
+    }
+
+    // 21 bits per axis. A wrapped key only adds candidates, never loses them
+    auto cellKey = [](const Long64_t* cell) {
+        return ((ULong64_t)cell[0] & 0x1FFFFF) | (((ULong64_t)cell[1] & 0x1FFFFF) << 21) |
+               (((ULong64_t)cell[2] & 0x1FFFFF) << 42);
+    };
+
+    fCells.assign(3 * nHits, 0);
+    fCellHead.clear();
+    fCellNext.assign(nHits, -1);
+    for (Int_t n = 0; n < nHits; n++) {
+        const Double_t position[3] = {hits->GetX(n), hits->GetY(n), hits->GetZ(n)};
+        for (int axis = 0; axis < 3; axis++) {
+            if (useAxis[axis] && std::isfinite(position[axis]))
+                fCells[3 * n + axis] = (Long64_t)std::floor(position[axis] / distance);
+        }
+
+        auto cell = fCellHead.emplace(cellKey(&fCells[3 * n]), n);
+        if (!cell.second) {
+            fCellNext[n] = cell.first->second;
+            cell.first->second = n;
+        }
+    }
+
+    // Energy, and energy weighted x, y, z and time of each hit, accumulated in the absorbing hit
+    fSums.resize(5 * nHits);
+    fHitValues.resize(4 * nHits);
+    for (Int_t n = 0; n < nHits; n++) {
+        Double_t* values = &fHitValues[4 * n];
+        values[0] = hits->GetX(n);
+        values[1] = hits->GetY(n);
+        values[2] = hits->GetZ(n);
+        values[3] = hits->GetTime(n);
+
+        const Double_t energy = hits->GetEnergy(n);
+        Double_t* sum = &fSums[5 * n];
+        sum[0] = energy;
+        for (int k = 0; k < 4; k++) sum[k + 1] = energy * values[k];
+    }
+
+    // The centroid of a cluster without energy is the position of its absorbing hit
+    auto clusterValue = [&](Int_t i, int k) {
+        const Double_t* sum = &fSums[5 * i];
+        return sum[0] == 0 ? fHitValues[4 * i + k] : sum[k + 1] / sum[0];
+    };
+
+    // The squared distance from the centroid of an absorbing hit to another hit, over the coordinates
+    // defined by both types, as given by TRestHits::GetDistance2
+    const Int_t axisTypes[3] = {X, Y, Z};
+    auto centroidDistance2 = [&](Int_t i, Int_t j) {
+        Double_t distance2 = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            if (fTypes[i] % axisTypes[axis] != 0 || fTypes[j] % axisTypes[axis] != 0) continue;
+            const Double_t delta = clusterValue(i, axis) - fHitValues[4 * j + axis];
+            distance2 += delta * delta;
+        }
+        return distance2;
+    };
+
+    const Double_t distance2 = distance * distance;
+    const Int_t range[3] = {useAxis[0] ? 1 : 0, useAxis[1] ? 1 : 0, useAxis[2] ? 1 : 0};
+
+    Bool_t merged = false;
+    fCluster.assign(nHits, -1);
+    fAbsorbed.assign(nHits, false);
+    for (Int_t i = 0; i < nHits; i++) {
+        if (fCluster[i] != -1) continue;
+        fCluster[i] = i;
+
+        // The previous hits are already merged, so all the candidates follow the absorbing hit
+        fCandidates.clear();
+        for (int dx = -range[0]; dx <= range[0]; dx++) {
+            for (int dy = -range[1]; dy <= range[1]; dy++) {
+                for (int dz = -range[2]; dz <= range[2]; dz++) {
+                    const Long64_t neighbour[3] = {fCells[3 * i] + dx, fCells[3 * i + 1] + dy,
+                                                   fCells[3 * i + 2] + dz};
+                    auto cell = fCellHead.find(cellKey(neighbour));
+                    if (cell == fCellHead.end()) continue;
+
+                    for (Int_t j = cell->second; j != -1; j = fCellNext[j]) {
+                        if (fCluster[j] == -1) fCandidates.push_back(j);
+                    }
+                }
+            }
+        }
+        sort(fCandidates.begin(), fCandidates.end());
+
+        for (const Int_t j : fCandidates) {
+            if (centroidDistance2(i, j) < distance2) {
+                fCluster[j] = i;
+                fAbsorbed[i] = true;
+                for (int k = 0; k < 5; k++) fSums[5 * i + k] += fSums[5 * j + k];
+                merged = true;
+            }
+        }
+    }
+
+    if (!merged) return false;
+
+    hits->RemoveHits();
+    for (Int_t n = 0; n < nHits; n++) {
+        if (fCluster[n] != n) continue;
+        if (!fAbsorbed[n]) {
+            const Double_t* values = &fHitValues[4 * n];
+            hits->AddHit({values[0], values[1], values[2]}, fSums[5 * n], values[3], fTypes[n]);
+            continue;
+        }
+        hits->AddHit({clusterValue(n, 0), clusterValue(n, 1), clusterValue(n, 2)}, fSums[5 * n],
+                     clusterValue(n, 3), fTypes[n]);
+    }
+
+    return true;
+}
+
 void TRestDetectorHitsReductionProcess::EndProcess() {}
 
 void TRestDetectorHitsReductionProcess::InitFromConfigFile() {
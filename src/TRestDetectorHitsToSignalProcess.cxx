@@ -64,6 +64,9 @@
 /// if TRestDetectorGas is used.
 /// * **sampling**: The physical time, even if it is given as a physical time,
 /// will be discretized according to the sampling time given.
+/// * **quantization**: If it is positive, the charge of the output signals will
+/// be stored as 16-bit ADC values, quantized in steps of the given value. See
+/// TRestDetectorSignalEvent::SetADCStorage.
 ///
 /// \htmlonly <style>div.image img[src="hitsToSignal.png"]{width:800px;}</style> \endhtmlonly
 ///
@@ -216,6 +219,9 @@ void TRestDetectorHitsToSignalProcess::InitProcess() {
             this->SetError("The readout was not properly initialized.");
         }
     }
+
+    // The readout gives the channel name and type of the signals created without them
+    fSignalEvent->SetReadout(fReadout);
 }
 
 ///////////////////////////////////////////////
@@ -303,11 +309,17 @@ TRestEvent* TRestDetectorHitsToSignalProcess::ProcessEvent(TRestEvent* inputEven
                               << fHitsEvent->GetID() << RESTendl;
                     exit(1);
                 }
-                fSignalEvent->AddChargeToSignal(daqId, time, energy);
-
                 auto signal = fSignalEvent->GetSignalById(daqId);
-                signal->SetSignalName(channel->GetChannelName());
-                signal->SetSignalType(channel->GetChannelType());
+                if (signal == nullptr) {
+                    // The channel labels are assigned only once, when the signal is created
+                    fSignalEvent->AddChargeToSignal(daqId, time, energy);
+
+                    signal = fSignalEvent->GetSignal(fSignalEvent->GetNumberOfSignals() - 1);
+                    signal->SetSignalName(channel->GetChannelName());
+                    signal->SetSignalType(channel->GetChannelType());
+                } else {
+                    signal->IncreaseAmplitude(time, energy);
+                }
 
             } else {
                 if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug) {
@@ -319,6 +331,11 @@ TRestEvent* TRestDetectorHitsToSignalProcess::ProcessEvent(TRestEvent* inputEven
     }
 
     fSignalEvent->SortSignals();
+    // The signals are sparse, the sampling grid gaps are stored as segments
+    fSignalEvent->SetImplicitTimeAxis(fSampling);
+    if (fQuantization > 0) {
+        fSignalEvent->SetADCStorage(fQuantization);
+    }
 
     if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug) {
         cout << "TRestDetectorHitsToSignalProcess : Number of signals added : "
@@ -16,6 +16,7 @@
 
 #include "TRestDetectorPositionMappingProcess.h"
 
+#include <TFile.h>
 #include <TLegend.h>
 #include <TPaveText.h>
 #include <TRandom.h>
@@ -26,6 +27,11 @@ ClassImp(TRestDetectorPositionMappingProcess);
 
 TRestDetectorPositionMappingProcess::TRestDetectorPositionMappingProcess() { Initialize(); }
 
+TRestDetectorPositionMappingProcess::TRestDetectorPositionMappingProcess(const char* configFilename) {
+    Initialize();
+    LoadConfigFromFile(configFilename);
+}
+
 TRestDetectorPositionMappingProcess::~TRestDetectorPositionMappingProcess() {}
 
 void TRestDetectorPositionMappingProcess::Initialize() {
@@ -35,6 +41,11 @@ void TRestDetectorPositionMappingProcess::Initialize() {
     fHitsEvent = nullptr;
 
     fReadout = nullptr;
+    fCalib = nullptr;
+
+    fAreaThrIntegralSum = nullptr;
+    fAreaCounts = nullptr;
+    fAreaGainMap = nullptr;
 }
 
 void TRestDetectorPositionMappingProcess::InitProcess() {
@@ -127,48 +138,124 @@ double TRestDetectorPositionMappingProcess::GetCorrection3(double x, double y, d
 
 void TRestDetectorPositionMappingProcess::EndProcess() {
     if (fCreateGainMap) {
-        // Calculate the mean of each bin's spectrum
-        double sum = 0;
-        double n = 0;
-        for (int i = 1; i <= fAreaGainMap->GetNbinsX(); i++) {
-            for (int j = 1; j <= fAreaGainMap->GetNbinsY(); j++) {
-                if (fAreaCounts->GetBinContent(i, j) > 100) {
-                    double meanthrintegral =
-                        fAreaThrIntegralSum->GetBinContent(i, j) / fAreaCounts->GetBinContent(i, j);
-                    fAreaGainMap->SetBinContent(i, j, meanthrintegral);
-                    sum += meanthrintegral;
-                    n++;
-                }
+        if (!fAccumulatorSave.empty()) SaveAccumulators(fAccumulatorSave);
+        FitAreaGain();
+        SaveGainMap(fMappingSave);
+    }
+}
+
+void TRestDetectorPositionMappingProcess::FitAreaGain() {
+    // Calculate the mean of each bin's spectrum
+    double sum = 0;
+    double n = 0;
+    for (int i = 1; i <= fAreaGainMap->GetNbinsX(); i++) {
+        for (int j = 1; j <= fAreaGainMap->GetNbinsY(); j++) {
+            if (fAreaCounts->GetBinContent(i, j) > 100) {
+                double meanthrintegral =
+                    fAreaThrIntegralSum->GetBinContent(i, j) / fAreaCounts->GetBinContent(i, j);
+                fAreaGainMap->SetBinContent(i, j, meanthrintegral);
+                sum += meanthrintegral;
+                n++;
             }
         }
+    }
 
-        // the mean value of all the valued bins
-        double meanmean = sum / n;
-
-        // normalize and fill the result
-        for (int i = 1; i <= fAreaGainMap->GetNbinsX(); i++) {
-            for (int j = 1; j <= fAreaGainMap->GetNbinsY(); j++) {
-                if (fAreaGainMap->GetBinContent(i, j) == 0) {
-                    fAreaGainMap->SetBinContent(i, j, 1);
-                } else {
-                    fAreaGainMap->SetBinContent(i, j, meanmean / fAreaGainMap->GetBinContent(i, j));
-                }
+    // the mean value of all the valued bins
+    double meanmean = sum / n;
+
+    // normalize and fill the result
+    for (int i = 1; i <= fAreaGainMap->GetNbinsX(); i++) {
+        for (int j = 1; j <= fAreaGainMap->GetNbinsY(); j++) {
+            if (fAreaGainMap->GetBinContent(i, j) == 0) {
+                fAreaGainMap->SetBinContent(i, j, 1);
+            } else {
+                fAreaGainMap->SetBinContent(i, j, meanmean / fAreaGainMap->GetBinContent(i, j));
             }
         }
+    }
 
-        if (fCalib == nullptr) {
-            fCalib = new TRestDetectorGainMap();
-        }
-        fCalib->f2DGainMapping = fAreaGainMap;
-        fCalib->SetName("PositionCalibration");
-
-        TRestRun* r = new TRestRun();
-        r->SetOutputFileName(fMappingSave);
-        r->AddMetadata(fCalib);
-        r->AddMetadata(fReadout);
-        r->FormOutputFile();
-        if (fAreaGainMap != nullptr) fAreaGainMap->Write();
+    if (fCalib == nullptr) {
+        fCalib = new TRestDetectorGainMap();
+    }
+    fCalib->f2DGainMapping = fAreaGainMap;
+    fCalib->SetName("PositionCalibration");
+}
+
+void TRestDetectorPositionMappingProcess::SaveGainMap(string filename) {
+    TRestRun* r = new TRestRun();
+    r->SetOutputFileName(filename);
+    r->AddMetadata(fCalib);
+    if (fReadout != nullptr) r->AddMetadata(fReadout);
+    r->FormOutputFile();
+    if (fAreaGainMap != nullptr) fAreaGainMap->Write();
+}
+
+// The energy sum and counts of each area are the raw accumulators of the gain calibration.
+// The ones of several runs processed separately can be added with AddAccumulators before
+// a single call to FitAreaGain.
+void TRestDetectorPositionMappingProcess::SaveAccumulators(string filename) {
+    TDirectory* dir = gDirectory;
+    TFile* f = TFile::Open(filename.c_str(), "RECREATE");
+    if (f == nullptr || f->IsZombie()) {
+        RESTError << "cannot create accumulator file: " << filename << RESTendl;
+        delete f;
+        dir->cd();
+        return;
     }
+
+    TNamed("accumulator", ClassName()).Write();
+    fAreaThrIntegralSum->Write("areaThrIntegralSum");
+    fAreaCounts->Write("areaCounts");
+
+    f->Close();
+    delete f;
+    dir->cd();
+
+    cout << "TRestDetectorPositionMappingProcess: area sums saved to " << filename << endl;
+}
+
+// It adds the area sums saved by SaveAccumulators to the ones of this process. If the
+// process was not initialized with a readout, the binning is taken from the file.
+Bool_t TRestDetectorPositionMappingProcess::AddAccumulators(string filename) {
+    TDirectory* dir = gDirectory;
+    TFile* f = TFile::Open(filename.c_str());
+    if (f == nullptr || f->IsZombie()) {
+        RESTError << "cannot open accumulator file: " << filename << RESTendl;
+        delete f;
+        dir->cd();
+        return false;
+    }
+
+    bool ok = true;
+    TNamed* type = (TNamed*)f->Get("accumulator");
+    TH2D* sum = (TH2D*)f->Get("areaThrIntegralSum");
+    TH2D* counts = (TH2D*)f->Get("areaCounts");
+    if (type == nullptr || (string)type->GetTitle() != ClassName() || sum == nullptr || counts == nullptr) {
+        RESTError << "not a " << ClassName() << " accumulator file: " << filename << RESTendl;
+        ok = false;
+    } else if (fAreaCounts == nullptr) {
+        dir->cd();
+        fAreaThrIntegralSum = (TH2D*)sum->Clone("areaThrIntegralSum");
+        fAreaCounts = (TH2D*)counts->Clone("areaCounts");
+        const TAxis* x = counts->GetXaxis();
+        const TAxis* y = counts->GetYaxis();
+        fAreaGainMap = new TH2F("areaGainMap", "areaGainMap", x->GetNbins(), x->GetXmin(), x->GetXmax(),
+                                y->GetNbins(), y->GetXmin(), y->GetXmax());
+    } else if (counts->GetNbinsX() != fAreaCounts->GetNbinsX() ||
+               counts->GetNbinsY() != fAreaCounts->GetNbinsY()) {
+        RESTError << "inconsistent area binning in accumulator file: " << filename << RESTendl;
+        ok = false;
+    } else {
+        fAreaThrIntegralSum->Add(sum);
+        fAreaCounts->Add(counts);
+    }
+
+    delete type;
+    f->Close();
+    delete f;
+    dir->cd();
+
+    return ok;
 }
 
 // setting amplification:
@@ -193,6 +280,7 @@ void TRestDetectorPositionMappingProcess::InitFromConfigFile() {
     fEnergyCutRange = StringTo2DVector(GetParameter("energyRange", "(0,1e9)"));
     fNHitsCutRange = StringTo2DVector(GetParameter("nHitsRange", "(4,14)"));
     fMappingSave = GetParameter("save", "calib.root");
+    fAccumulatorSave = GetParameter("accumulatorSave", "");
 
     fNBinsX = StringToDouble(GetParameter("nBinsX", "100"));
     fNBinsY = StringToDouble(GetParameter("nBinsY", "100"));
@@ -33,8 +33,11 @@
 #include <TRandom3.h>
 
 #include <algorithm>
+#include <map>
 #include <limits>
 
+#include "TRestDetectorSignalEvent.h"
+
 using namespace std;
 
 ClassImp(TRestDetectorSignal);
@@ -51,11 +54,346 @@ TRestDetectorSignal::TRestDetectorSignal() {
 
 TRestDetectorSignal::~TRestDetectorSignal() = default;
 
+TRestDetectorSignal::TRestDetectorSignal(const TRestDetectorSignal& signal) : TRestDetectorSignal() {
+    *this = signal;
+}
+
+///////////////////////////////////////////////
+/// \brief It copies the points and the labels of the given signal. The copy does not
+/// belong to any event, so the labels are resolved and stored at its own dictionary.
+/// The graph is not copied, since each signal owns its graph.
+///
+TRestDetectorSignal& TRestDetectorSignal::operator=(const TRestDetectorSignal& signal) {
+    if (this == &signal) {
+        return *this;
+    }
+
+    CopyPoints(signal);
+
+    const std::string name = signal.GetSignalName();
+    const std::string type = signal.GetSignalType();
+    fEvent = nullptr;
+    fLabels.clear();
+    fNameId = InternLabel(name);
+    fTypeId = InternLabel(type);
+
+    return *this;
+}
+
+///////////////////////////////////////////////
+/// \brief It copies the id, points and storage settings of the given signal, but not
+/// its labels. The vectors re-use their allocated memory.
+///
+void TRestDetectorSignal::CopyPoints(const TRestDetectorSignal& signal) {
+    InvalidateEventExtrema();
+    fSignalID = signal.fSignalID;
+    fSignalTime = signal.fSignalTime;
+    fSignalCharge = signal.fSignalCharge;
+    fTimeOrigin = signal.fTimeOrigin;
+    fTimeStep = signal.fTimeStep;
+    fSegmentStart = signal.fSegmentStart;
+    fSegmentOffset = signal.fSegmentOffset;
+    fSignalADC = signal.fSignalADC;
+    fADCScale = signal.fADCScale;
+    fADCOffset = signal.fADCOffset;
+    fPointsOverThreshold = signal.fPointsOverThreshold;
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the label (name or type) registered with the given id, or an
+/// empty string if it is not registered.
+///
+/// The label is resolved against the signal own dictionary if it is not empty or the
+/// signal does not belong to any event, and against the dictionary of the owning event
+/// otherwise. Signals of an event without a label take the name or type of their
+/// readout channel, if a readout has been assigned to the event. See
+/// TRestDetectorSignalEvent::SetReadout.
+///
+std::string TRestDetectorSignal::GetLabel(Int_t id, Bool_t type) const {
+    if (fEvent == nullptr || !fLabels.empty()) {
+        if (id < 0 || id >= (Int_t)fLabels.size()) {
+            return "";
+        }
+        return fLabels[id];
+    }
+    if (id < 0) {
+        return fEvent->GetReadoutLabel(fSignalID, type);
+    }
+    return fEvent->GetSignalLabel(id);
+}
+
+///////////////////////////////////////////////
+/// \brief It registers a label (name or type) at the corresponding labels dictionary
+/// and returns its id. Empty labels are not registered and -1 is returned.
+///
+Int_t TRestDetectorSignal::InternLabel(const std::string& label) {
+    if (label.empty()) {
+        return -1;
+    }
+    if (fEvent != nullptr && fLabels.empty()) {
+        return fEvent->InternSignalLabel(label);
+    }
+    for (size_t n = 0; n < fLabels.size(); n++) {
+        if (fLabels[n] == label) {
+            return n;
+        }
+    }
+    fLabels.push_back(label);
+    return fLabels.size() - 1;
+}
+
+///////////////////////////////////////////////
+/// \brief It informs the event owning the signal, if any, that its points have
+/// changed, so that the cached event extrema are recomputed on the next query.
+///
+void TRestDetectorSignal::InvalidateEventExtrema() {
+    if (fEvent != nullptr) {
+        fEvent->InvalidateExtrema();
+    }
+}
+
 void TRestDetectorSignal::NewPoint(Double_t time, Double_t data) {
-    fSignalTime.push_back(time);
+    InvalidateEventExtrema();
+    SetDoubleStorage();
+
+    if (HasImplicitTimeAxis()) {
+        if (fSignalCharge.empty()) {
+            fTimeOrigin = time;
+        } else if (TMath::Abs(time - GetTime(GetNumberOfPoints())) > 1.e-6 * fTimeStep) {
+            // The new point is not the next sample, the times need to be stored
+            SetExplicitTimeAxis();
+        }
+    }
+
+    if (!HasImplicitTimeAxis()) {
+        fSignalTime.push_back(time);
+    }
     fSignalCharge.push_back(data);
 }
 
+///////////////////////////////////////////////
+/// \brief It tries to replace the stored time values by an implicit time axis,
+/// given by the time of the first point and a constant sampling time.
+///
+/// The conversion only takes place if the points are sorted and placed on a uniform
+/// sampling grid. If `step` is zero, the sampling time is the minimum time difference
+/// between consecutive points. Signals with gaps on the grid are stored as segments of
+/// consecutive samples, as done by KeepRegions, but only if the segments have two
+/// points or more on average, since otherwise they do not take less memory than the
+/// time values. The return value indicates if the signal has an implicit time axis
+/// afterwards.
+///
+/// The remaining methods are not affected by the time axis representation. The
+/// time values will be stored again, by calling SetExplicitTimeAxis, as soon as a
+/// point that does not fit in the uniform sampling is added.
+///
+Bool_t TRestDetectorSignal::SetImplicitTimeAxis(Double_t step) {
+    if (HasImplicitTimeAxis()) {
+        return true;
+    }
+
+    const Int_t nPoints = GetNumberOfPoints();
+    if (nPoints < 2) {
+        return false;
+    }
+
+    if (step <= 0) {
+        step = fSignalTime[1] - fSignalTime[0];
+        for (int n = 2; n < nPoints; n++) {
+            step = min(step, fSignalTime[n] - fSignalTime[n - 1]);
+        }
+        if (step <= 0) {
+            return false;
+        }
+    }
+
+    const Double_t origin = fSignalTime[0];
+    std::vector<Int_t> segmentStart;
+    std::vector<Int_t> segmentOffset;
+    Int_t lastSample = -1;
+    for (int n = 0; n < nPoints; n++) {
+        const Double_t sample = (fSignalTime[n] - origin) / step;
+        const Int_t index = TMath::Nint(sample);
+        if (index <= lastSample || TMath::Abs(sample - index) > 1.e-6) {
+            return false;
+        }
+        if (index != lastSample + 1) {
+            segmentStart.push_back(index);
+            segmentOffset.push_back(n);
+        }
+        lastSample = index;
+    }
+
+    if (!segmentStart.empty()) {
+        if (2 * (segmentStart.size() + 1) > (size_t)nPoints) {
+            return false;
+        }
+        segmentStart.insert(segmentStart.begin(), 0);
+        segmentOffset.insert(segmentOffset.begin(), 0);
+    }
+
+    fTimeOrigin = origin;
+    fTimeStep = step;
+    fSegmentStart = std::move(segmentStart);
+    fSegmentOffset = std::move(segmentOffset);
+    fSignalTime.clear();
+    fSignalTime.shrink_to_fit();
+
+    return true;
+}
+
+///////////////////////////////////////////////
+/// \brief It fills the time values of each point from the implicit time axis, so
+/// that points with arbitrary times can be added to the signal.
+///
+void TRestDetectorSignal::SetExplicitTimeAxis() {
+    if (!HasImplicitTimeAxis()) {
+        return;
+    }
+
+    const Int_t nPoints = GetNumberOfPoints();
+    fSignalTime.resize(nPoints);
+    for (int n = 0; n < nPoints; n++) {
+        fSignalTime[n] = GetTime(n);
+    }
+
+    fTimeOrigin = 0;
+    fTimeStep = 0;
+    fSegmentStart.clear();
+    fSegmentOffset.clear();
+}
+
+///////////////////////////////////////////////
+/// \brief It removes every point outside the given regions of interest. Each
+/// region is given as a pair with the indices of its first and last points,
+/// both included, and they must be sorted. Overlapping regions are merged.
+///
+/// When the signal has an implicit time axis the remaining points are stored as
+/// segments of consecutive samples, so that the time values do not need to be
+/// stored again. The times of the remaining points are not modified in any case,
+/// and the rest of methods see the suppressed signal as a signal with fewer points.
+///
+void TRestDetectorSignal::KeepRegions(const std::vector<std::pair<Int_t, Int_t>>& regions) {
+    InvalidateEventExtrema();
+    const Int_t nPoints = GetNumberOfPoints();
+    const Bool_t implicit = HasImplicitTimeAxis();
+
+    std::vector<Int_t> segmentStart;
+    std::vector<Int_t> segmentOffset;
+
+    // Points are moved towards the front, so that every point is read before being overwritten
+    Int_t kept = 0;
+    Int_t nextPoint = 0;
+    Int_t lastSample = 0;
+    for (const auto& [first, last] : regions) {
+        const Int_t from = max(first, nextPoint);
+        const Int_t to = min(last, nPoints - 1);
+        for (int n = from; n <= to; n++) {
+            if (implicit) {
+                const Int_t sample = GetSampleIndex(n);
+                if (kept == 0 || sample != lastSample + 1) {
+                    segmentStart.push_back(sample);
+                    segmentOffset.push_back(kept);
+                }
+                lastSample = sample;
+            } else {
+                fSignalTime[kept] = fSignalTime[n];
+            }
+            if (HasADCStorage()) {
+                fSignalADC[kept] = fSignalADC[n];
+            } else {
+                fSignalCharge[kept] = fSignalCharge[n];
+            }
+            kept++;
+        }
+        nextPoint = max(nextPoint, to + 1);
+    }
+
+    if (HasADCStorage()) {
+        fSignalADC.resize(kept);
+    } else {
+        fSignalCharge.resize(kept);
+    }
+
+    if (!implicit) {
+        fSignalTime.resize(kept);
+        return;
+    }
+
+    // A single segment starting at the time origin is a contiguous time axis
+    if (segmentStart.size() == 1 && segmentStart[0] == 0) {
+        segmentStart.clear();
+        segmentOffset.clear();
+    }
+    fSegmentStart = std::move(segmentStart);
+    fSegmentOffset = std::move(segmentOffset);
+}
+
+///////////////////////////////////////////////
+/// \brief It stores the signal charge as 16-bit ADC values, so that each
+/// point charge is given by `offset + scale * adc`.
+///
+/// For digitized data, i.e. integer charge values, the default scale and
+/// offset give a lossless conversion. For simulated data the scale defines the
+/// charge quantization. Values outside the 16-bit range are saturated.
+///
+/// It returns true if the conversion did not modify any charge value.
+///
+/// The charge is converted back to double precision, by calling SetDoubleStorage,
+/// as soon as a method modifying the charge values is used.
+///
+Bool_t TRestDetectorSignal::SetADCStorage(Double_t scale, Double_t offset) {
+    if (scale == 0) {
+        RESTError << "TRestDetectorSignal::SetADCStorage. The ADC scale cannot be zero" << RESTendl;
+        return false;
+    }
+
+    InvalidateEventExtrema();
+    SetDoubleStorage();
+
+    const Int_t nPoints = GetNumberOfPoints();
+    fSignalADC.resize(nPoints);
+
+    Bool_t lossless = true;
+    for (int n = 0; n < nPoints; n++) {
+        Double_t adc = (fSignalCharge[n] - offset) / scale;
+        if (adc > numeric_limits<Short_t>::max()) adc = numeric_limits<Short_t>::max();
+        if (adc < numeric_limits<Short_t>::min()) adc = numeric_limits<Short_t>::min();
+
+        fSignalADC[n] = (Short_t)TMath::Nint(adc);
+        if (offset + scale * fSignalADC[n] != fSignalCharge[n]) {
+            lossless = false;
+        }
+    }
+
+    fADCScale = scale;
+    fADCOffset = offset;
+    fSignalCharge.clear();
+    fSignalCharge.shrink_to_fit();
+
+    return lossless;
+}
+
+///////////////////////////////////////////////
+/// \brief It restores the signal charge values in double precision.
+///
+void TRestDetectorSignal::SetDoubleStorage() {
+    if (!HasADCStorage()) {
+        return;
+    }
+
+    const Int_t nPoints = GetNumberOfPoints();
+    fSignalCharge.resize(nPoints);
+    for (int n = 0; n < nPoints; n++) {
+        fSignalCharge[n] = GetData(n);
+    }
+
+    fSignalADC.clear();
+    fSignalADC.shrink_to_fit();
+    fADCScale = 0;
+    fADCOffset = 0;
+}
+
 ///////////////////////////////////////////////
 /// \brief If the point already exists inside the detector signal event,
 /// the amplitude value will be added to the corresponding time.
@@ -69,16 +407,16 @@ void TRestDetectorSignal::IncreaseAmplitude(Double_t t, Double_t d) { IncreaseAm
 /// The input vector should contain a physical time and an amplitude.
 ///
 void TRestDetectorSignal::IncreaseAmplitude(const TVector2& p) {
+    InvalidateEventExtrema();
     Double_t x = p.X();
     Double_t y = p.Y();
     Int_t index = GetTimeIndex(x);
 
     if (index >= 0) {
-        fSignalTime[index] = x;
+        SetDoubleStorage();
         fSignalCharge[index] += y;
     } else {
-        fSignalTime.push_back(x);
-        fSignalCharge.push_back(y);
+        NewPoint(x, y);
     }
 }
 
@@ -90,16 +428,16 @@ void TRestDetectorSignal::IncreaseAmplitude(const TVector2& p) {
 /// The input vector should contain a physical time and an amplitude.
 ///
 void TRestDetectorSignal::SetPoint(const TVector2& p) {
+    InvalidateEventExtrema();
     Int_t index = GetTimeIndex(p.X());
     Double_t x = p.X();
     Double_t y = p.Y();
 
     if (index >= 0) {
-        fSignalTime[index] = x;
+        SetDoubleStorage();
         fSignalCharge[index] = y;
     } else {
-        fSignalTime.push_back(x);
-        fSignalCharge.push_back(y);
+        NewPoint(x, y);
     }
 }
 
@@ -120,7 +458,14 @@ void TRestDetectorSignal::SetPoint(Double_t t, Double_t d) {
 /// given index
 ///
 void TRestDetectorSignal::SetPoint(Int_t index, Double_t t, Double_t d) {
-    fSignalTime[index] = t;
+    InvalidateEventExtrema();
+    SetDoubleStorage();
+    if (HasImplicitTimeAxis() && t != GetTime(index)) {
+        SetExplicitTimeAxis();
+    }
+    if (!HasImplicitTimeAxis()) {
+        fSignalTime[index] = t;
+    }
     fSignalCharge[index] = d;
 }
 
@@ -141,7 +486,9 @@ Double_t TRestDetectorSignal::GetIntegral(Int_t startBin, Int_t endBin) const {
 }
 
 void TRestDetectorSignal::Normalize(Double_t scale) {
+    InvalidateEventExtrema();
     Double_t sum = GetIntegral();
+    SetDoubleStorage();
     for (int i = 0; i < GetNumberOfPoints(); i++) {
         fSignalCharge[i] = scale * GetData(i) / sum;
     }
@@ -294,10 +641,14 @@ Int_t TRestDetectorSignal::GetMaxIndex(Int_t from, Int_t to) {
 optional<pair<Double_t, Double_t>>
 TRestDetectorSignal::GetPeakGauss()  // returns a 2vector with the time of the peak time in us and the energy
 {
-    const auto indexMax =
-        std::distance(fSignalCharge.begin(), std::max_element(fSignalCharge.begin(), fSignalCharge.end()));
-    const auto timeMax = fSignalTime[indexMax];
-    const auto signalMax = fSignalCharge[indexMax];
+    Int_t indexMax = 0;
+    for (int i = 1; i < GetNumberOfPoints(); i++) {
+        if (GetData(i) > GetData(indexMax)) {
+            indexMax = i;
+        }
+    }
+    const auto timeMax = GetTime(indexMax);
+    const auto signalMax = GetData(indexMax);
 
     // Define fit limits
     Double_t threshold = signalMax * 0.9;  // 90% of the maximum value
@@ -306,22 +657,23 @@ TRestDetectorSignal::GetPeakGauss()  // returns a 2vector with the time of the p
 
     // Find the lower limit: time when signal drops to 90% of the max before the peak
     for (auto i = indexMax; i >= 0; --i) {
-        if (fSignalCharge[i] <= threshold) {
-            lowerLimit = fSignalTime[i];
+        if (GetData(i) <= threshold) {
+            lowerLimit = GetTime(i);
             break;
         }
     }
     // Find the upper limit: time when signal drops to 90% of the max after the peak
     for (auto i = indexMax; i < GetNumberOfPoints(); ++i) {
-        if (fSignalCharge[i] <= threshold) {
-            lowerLimit = fSignalTime[i];
+        if (GetData(i) <= threshold) {
+            lowerLimit = GetTime(i);
             break;
         }
     }
 
-    TF1 gauss("gaus", "gaus", lowerLimit, upperLimit);
+    TF1 gauss("gaus", "gaus", lowerLimit, upperLimit, TF1::EAddToList::kNo);
 
-    auto signal_graph = std::unique_ptr<TGraph>(GetGraph());
+    // A graph owned by the fit, so that the graph returned by GetGraph is not modified
+    auto signal_graph = NewGraph();
 
     TFitResultPtr fitResult =
         signal_graph->Fit(&gauss, "QNRS");  // Q = quiet, no info in screen; N = no plot; R = fit in
@@ -367,9 +719,10 @@ TRestDetectorSignal::GetPeakLandau()  // returns a 2vector with the time of the
         }
     }
 
-    TF1 landau("landau", "landau", lowerLimit, upperLimit);
+    TF1 landau("landau", "landau", lowerLimit, upperLimit, TF1::EAddToList::kNo);
 
-    auto signal_graph = std::unique_ptr<TGraph>(GetGraph());
+    // A graph owned by the fit, so that the graph returned by GetGraph is not modified
+    auto signal_graph = NewGraph();
 
     TFitResultPtr fitResult =
         signal_graph->Fit(&landau, "QNRS");  // Q = quiet, no info in screen; N = no plot; R = fit in the
@@ -426,10 +779,11 @@ TRestDetectorSignal::GetPeakAget()  // returns a 2vector with the time of the pe
         }
     }
 
-    TF1 aget("aget", agetResponseFunction, lowerLimit, upperLimit, 3);  //
+    TF1 aget("aget", agetResponseFunction, lowerLimit, upperLimit, 3, 1, TF1::EAddToList::kNo);
     aget.SetParameters(500, maxRawTime, 1.2);
 
-    auto signal_graph = std::unique_ptr<TGraph>(GetGraph());
+    // A graph owned by the fit, so that the graph returned by GetGraph is not modified
+    auto signal_graph = NewGraph();
 
     TFitResultPtr fitResult =
         signal_graph->Fit(&aget, "QNRS");  // Q = quiet, no info in screen; N = no plot; R = fit in
@@ -445,6 +799,195 @@ TRestDetectorSignal::GetPeakAget()  // returns a 2vector with the time of the pe
     return make_pair(time, energy);
 }
 
+///////////////////////////////////////////////
+/// \brief Fast alternative to GetPeakGauss. It returns the time and the amplitude of
+/// the gaussian passing through the maximum point and its two neighbours, obtained in
+/// closed form as the vertex of the parabola that interpolates the logarithm of the
+/// three points.
+///
+/// If `residual` is given, it is filled with the RMS difference between the gaussian
+/// and the signal points within two sigmas from the peak, relative to the amplitude.
+///
+/// It returns nullopt if the three points do not define a gaussian, i.e. if any of
+/// them is not positive or the maximum is found at the signal edges.
+///
+optional<pair<Double_t, Double_t>> TRestDetectorSignal::GetPeakGaussFast(Double_t* residual) const {
+    const Int_t nPoints = GetNumberOfPoints();
+
+    Int_t indexMax = 0;
+    for (int i = 1; i < nPoints; i++) {
+        if (GetData(i) > GetData(indexMax)) {
+            indexMax = i;
+        }
+    }
+    if (indexMax == 0 || indexMax == nPoints - 1) {
+        return nullopt;
+    }
+
+    const Double_t y0 = GetData(indexMax - 1);
+    const Double_t y1 = GetData(indexMax);
+    const Double_t y2 = GetData(indexMax + 1);
+    if (y0 <= 0 || y1 <= 0 || y2 <= 0) {
+        return nullopt;
+    }
+
+    // Parabola through (u, log(y)), with u the time relative to the maximum point
+    const Double_t u0 = GetTime(indexMax - 1) - GetTime(indexMax);
+    const Double_t u2 = GetTime(indexMax + 1) - GetTime(indexMax);
+    const Double_t l0 = TMath::Log(y0) - TMath::Log(y1);
+    const Double_t l2 = TMath::Log(y2) - TMath::Log(y1);
+
+    const Double_t denominator = u0 * u2 * (u0 - u2);
+    if (denominator == 0) {
+        return nullopt;
+    }
+    const Double_t a = (u2 * l0 - u0 * l2) / denominator;
+    const Double_t b = (u0 * u0 * l2 - u2 * u2 * l0) / denominator;
+    if (a >= 0) {
+        return nullopt;
+    }
+
+    const Double_t center = -b / (2 * a);
+    const Double_t sigma = TMath::Sqrt(-1. / (2 * a));
+    const Double_t amplitude = y1 * TMath::Exp(-b * b / (4 * a));
+    const Double_t time = GetTime(indexMax) + center;
+
+    if (residual != nullptr) {
+        Double_t sum = 0;
+        Int_t n = 0;
+        for (int i = 0; i < nPoints; i++) {
+            const Double_t x = (GetTime(i) - time) / sigma;
+            if (TMath::Abs(x) > 2) {
+                continue;
+            }
+            const Double_t difference = GetData(i) - amplitude * TMath::Exp(-0.5 * x * x);
+            sum += difference * difference;
+            n++;
+        }
+        *residual = n > 0 ? TMath::Sqrt(sum / n) / amplitude : 0;
+    }
+
+    return make_pair(time, amplitude);
+}
+
+///////////////////////////////////////////////
+/// \brief Fast alternative to GetPeakAget. It fits the aget response function to the
+/// same signal range used by GetPeakAget, using a fixed number of Gauss-Newton
+/// iterations on the signal points, without creating any ROOT object.
+///
+/// If `residual` is given, it is filled with the RMS difference between the fitted
+/// function and the signal points in the fit range, relative to the amplitude.
+///
+/// It returns nullopt if the fit range contains less than three points, or if the
+/// iterations lead to a singular system or to unphysical parameters.
+///
+optional<pair<Double_t, Double_t>> TRestDetectorSignal::GetPeakAgetFast(Double_t* residual) const {
+    const Int_t nPoints = GetNumberOfPoints();
+    if (nPoints < 3) {
+        return nullopt;
+    }
+
+    Int_t indexMax = 0;
+    for (int i = 1; i < nPoints; i++) {
+        if (GetData(i) > GetData(indexMax)) {
+            indexMax = i;
+        }
+    }
+
+    // Same fit range as GetPeakAget
+    const Double_t threshold = GetData(indexMax) * 0.9;
+    Int_t from = indexMax, to = indexMax;
+    while (from > 0 && GetData(from) > threshold) from--;
+    while (to < nPoints - 1 && GetData(to) > threshold) to++;
+    if (to - from + 1 < 3) {
+        return nullopt;
+    }
+
+    // Amplitude normalization and position of the maximum of the base function
+    const Double_t norm = 0.0440895;
+    const Double_t shift = 1.1664;
+
+    Double_t amplitude = GetData(indexMax);
+    Double_t peakTime = GetTime(indexMax);
+    Double_t width = 1.2;
+
+    const Int_t iterations = 20;
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        Double_t jtj[3][3] = {{0}};
+        Double_t jtr[3] = {0};
+
+        for (int i = from; i <= to; i++) {
+            const Double_t arg = (GetTime(i) - peakTime + shift) / width;
+            const Double_t e = TMath::Exp(-3 * arg);
+            const Double_t g = e * arg * arg * arg * TMath::Sin(arg);
+            const Double_t dg =
+                e * arg * arg * (3 * TMath::Sin(arg) - 3 * arg * TMath::Sin(arg) + arg * TMath::Cos(arg));
+
+            const Double_t jacobian[3] = {g / norm, -amplitude / norm * dg / width,
+                                          -amplitude / norm * dg * arg / width};
+            const Double_t r = GetData(i) - amplitude / norm * g;
+
+            for (int p = 0; p < 3; p++) {
+                jtr[p] += jacobian[p] * r;
+                for (int q = 0; q < 3; q++) {
+                    jtj[p][q] += jacobian[p] * jacobian[q];
+                }
+            }
+        }
+
+        // Small damping keeps the system regular when the range is short
+        for (int p = 0; p < 3; p++) {
+            jtj[p][p] *= 1 + 1.e-6;
+        }
+
+        const Double_t det = jtj[0][0] * (jtj[1][1] * jtj[2][2] - jtj[1][2] * jtj[2][1]) -
+                             jtj[0][1] * (jtj[1][0] * jtj[2][2] - jtj[1][2] * jtj[2][0]) +
+                             jtj[0][2] * (jtj[1][0] * jtj[2][1] - jtj[1][1] * jtj[2][0]);
+        if (det == 0 || !std::isfinite(det)) {
+            return nullopt;
+        }
+
+        // Cramer's rule for the 3x3 normal equations
+        Double_t step[3];
+        for (int p = 0; p < 3; p++) {
+            Double_t m[3][3];
+            for (int r = 0; r < 3; r++) {
+                for (int c = 0; c < 3; c++) {
+                    m[r][c] = (c == p) ? jtr[r] : jtj[r][c];
+                }
+            }
+            step[p] = (m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+                       m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+                       m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0])) /
+                      det;
+        }
+
+        amplitude += step[0];
+        peakTime += step[1];
+        width += step[2];
+
+        if (!std::isfinite(amplitude) || !std::isfinite(peakTime) || width <= 0) {
+            return nullopt;
+        }
+    }
+
+    if (peakTime < GetTime(from) || peakTime > GetTime(to) || amplitude <= 0) {
+        return nullopt;
+    }
+
+    if (residual != nullptr) {
+        Double_t sum = 0;
+        for (int i = from; i <= to; i++) {
+            const Double_t arg = (GetTime(i) - peakTime + shift) / width;
+            const Double_t f = amplitude / norm * TMath::Exp(-3 * arg) * arg * arg * arg * TMath::Sin(arg);
+            sum += (GetData(i) - f) * (GetData(i) - f);
+        }
+        *residual = TMath::Sqrt(sum / (to - from + 1)) / amplitude;
+    }
+
+    return make_pair(peakTime, amplitude);
+}
+
 Double_t TRestDetectorSignal::GetMaxPeakTime(Int_t from, Int_t to) { return GetTime(GetMaxIndex(from, to)); }
 
 Double_t TRestDetectorSignal::GetMinPeakValue() { return GetData(GetMinIndex()); }
@@ -467,6 +1010,9 @@ Double_t TRestDetectorSignal::GetMinTime() const {
     if (GetNumberOfPoints() == 0) {
         return 0;
     }
+    if (HasImplicitTimeAxis()) {
+        return GetTime(0);
+    }
     Double_t minTime = numeric_limits<Double_t>::max();
     for (int i = 0; i < GetNumberOfPoints(); i++) {
         const Double_t time = GetTime(i);
@@ -481,6 +1027,9 @@ Double_t TRestDetectorSignal::GetMaxTime() const {
     if (GetNumberOfPoints() == 0) {
         return 0;
     }
+    if (HasImplicitTimeAxis()) {
+        return GetTime(GetNumberOfPoints() - 1);
+    }
     Double_t maxTime = numeric_limits<Double_t>::min();
     for (int i = 0; i < GetNumberOfPoints(); i++) {
         const auto time = GetTime(i);
@@ -491,9 +1040,34 @@ Double_t TRestDetectorSignal::GetMaxTime() const {
     return maxTime;
 }
 
-Int_t TRestDetectorSignal::GetTimeIndex(Double_t t) {
+///////////////////////////////////////////////
+/// \brief It returns the index of the point at time `t`, or -1 if there is no
+/// point at that time. With an implicit time axis the index is obtained from the
+/// segments of samples, and times falling in a gap between segments give -1.
+///
+Int_t TRestDetectorSignal::GetTimeIndex(Double_t t) const {
     Double_t time = t;
 
+    if (HasImplicitTimeAxis()) {
+        const Int_t sample = TMath::Nint((time - fTimeOrigin) / fTimeStep);
+        Int_t n = sample;
+        if (!fSegmentStart.empty()) {
+            const auto next = std::upper_bound(fSegmentStart.begin(), fSegmentStart.end(), sample);
+            const Int_t segment = next - fSegmentStart.begin() - 1;
+            if (segment < 0) {
+                return -1;
+            }
+            n = fSegmentOffset[segment] + sample - fSegmentStart[segment];
+            if (segment + 1 < (Int_t)fSegmentOffset.size() && n >= fSegmentOffset[segment + 1]) {
+                return -1;
+            }
+        }
+        if (n >= 0 && n < GetNumberOfPoints() && TMath::Abs(time - GetTime(n)) <= 1.e-6 * fTimeStep) {
+            return n;
+        }
+        return -1;
+    }
+
     for (int n = 0; n < GetNumberOfPoints(); n++) {
         if (time == fSignalTime[n]) {
             return n;
@@ -502,7 +1076,134 @@ Int_t TRestDetectorSignal::GetTimeIndex(Double_t t) {
     return -1;
 }
 
+///////////////////////////////////////////////
+/// \brief It fills `averages` with the average charge of the signal points found
+/// in each time window of width `window`, as pairs of window index and average,
+/// in increasing window order. The window index of a point is its time divided
+/// by `window`, truncated to an integer. Empty windows are not included.
+///
+/// For a sorted signal the windows are contiguous, and they are accumulated in a
+/// single pass over the points. The vector is cleared first, so that it can be
+/// re-used between signals without new allocations.
+///
+void TRestDetectorSignal::GetWindowAverages(Double_t window,
+                                            std::vector<std::pair<Int_t, Double_t>>& averages) const {
+    averages.clear();
+
+    const Int_t nPoints = GetNumberOfPoints();
+    if (nPoints == 0) {
+        return;
+    }
+
+    if (!isSorted()) {
+        std::map<Int_t, std::pair<Int_t, Double_t>> windowMap;
+        for (int j = 0; j < nPoints; j++) {
+            auto& entry = windowMap[(Int_t)(GetTime(j) / window)];
+            entry.first++;
+            entry.second += GetData(j);
+        }
+        for (const auto& [index, entry] : windowMap) {
+            averages.emplace_back(index, entry.second / entry.first);
+        }
+        return;
+    }
+
+    Int_t index = GetTime(0) / window;
+    Int_t count = 0;
+    Double_t sum = 0;
+    for (int j = 0; j < nPoints; j++) {
+        const Int_t pointIndex = GetTime(j) / window;
+        if (pointIndex != index) {
+            averages.emplace_back(index, sum / count);
+            index = pointIndex;
+            count = 0;
+            sum = 0;
+        }
+        count++;
+        sum += GetData(j);
+    }
+    averages.emplace_back(index, sum / count);
+}
+
+///////////////////////////////////////////////
+/// \brief It fills `pulses` with the groups of consecutive points over
+/// `threshold`, in a single pass over the time ordered points.
+///
+/// Pulses with less than `minWidth` points are discarded. A pulse whose maximum
+/// is found less than `minSeparation` time units after the maximum of the
+/// previous pulse is merged into it. For each pulse the integral and the charge
+/// weighted mean time of its points over threshold are obtained.
+///
+/// The vector is cleared first, so that it can be re-used between signals
+/// without new allocations.
+///
+void TRestDetectorSignal::GetPulses(Double_t threshold, std::vector<Pulse>& pulses, Int_t minWidth,
+                                    Double_t minSeparation) const {
+    pulses.clear();
+
+    Pulse pulse;
+    Bool_t inPulse = false;
+    Double_t timeSum = 0;
+
+    auto closePulse = [&]() {
+        if (pulse.lastIndex - pulse.firstIndex + 1 < minWidth) {
+            return;
+        }
+
+        if (!pulses.empty() && GetTime(pulse.maxIndex) - GetTime(pulses.back().maxIndex) < minSeparation) {
+            Pulse& previous = pulses.back();
+            const Double_t previousTimeSum = previous.time * previous.integral;
+            previous.lastIndex = pulse.lastIndex;
+            if (pulse.maxValue > previous.maxValue) {
+                previous.maxValue = pulse.maxValue;
+                previous.maxIndex = pulse.maxIndex;
+            }
+            previous.integral += pulse.integral;
+            previous.time = previous.integral != 0 ? (previousTimeSum + timeSum) / previous.integral
+                                                   : GetTime(previous.maxIndex);
+            return;
+        }
+
+        pulse.time = pulse.integral != 0 ? timeSum / pulse.integral : GetTime(pulse.maxIndex);
+        pulses.push_back(pulse);
+    };
+
+    const Int_t nPoints = GetNumberOfPoints();
+    for (int i = 0; i < nPoints; i++) {
+        const Double_t value = GetData(i);
+        if (value <= threshold) {
+            if (inPulse) {
+                closePulse();
+                inPulse = false;
+            }
+            continue;
+        }
+
+        if (!inPulse) {
+            pulse = Pulse();
+            pulse.firstIndex = i;
+            pulse.maxIndex = i;
+            pulse.maxValue = value;
+            timeSum = 0;
+            inPulse = true;
+        }
+        pulse.lastIndex = i;
+        pulse.integral += value;
+        timeSum += value * GetTime(i);
+        if (value > pulse.maxValue) {
+            pulse.maxValue = value;
+            pulse.maxIndex = i;
+        }
+    }
+    if (inPulse) {
+        closePulse();
+    }
+}
+
 Bool_t TRestDetectorSignal::isSorted() const {
+    if (HasImplicitTimeAxis()) {
+        return true;
+    }
     for (int i = 0; i < GetNumberOfPoints() - 1; i++) {
         if (GetTime(i + 1) < GetTime(i)) {
             return false;
@@ -513,6 +1214,7 @@ Bool_t TRestDetectorSignal::isSorted() const {
 
 void TRestDetectorSignal::Sort() {
     while (!isSorted()) {
+        SetDoubleStorage();
         for (int i = 0; i < GetNumberOfPoints(); i++) {
             for (int j = i; j < GetNumberOfPoints(); j++) {
                 if (GetTime(i) > GetTime(j)) {
@@ -571,11 +1273,93 @@ void TRestDetectorSignal::GetSignalSmoothed(TRestDetectorSignal* smthSignal, Int
         smthSignal->IncreaseAmplitude(GetTime(i), sum / averagingPoints);
 }
 
+///////////////////////////////////////////////
+/// \brief It returns the signal maximum and minimum values and their indices, the
+/// integral, the time extent, and the baseline and baseline sigma within the bin
+/// range [baseLineStart, baseLineEnd), all of them obtained together in a single
+/// pass over the charge values, plus a pass over the baseline range.
+///
+/// The results are equivalent to calling GetMaxPeakValue, GetMinPeakValue,
+/// GetIntegral, GetBaseLine, GetBaseLineSigma, GetMinTime and GetMaxTime, except
+/// that the maximum is the actual maximum value also for signals without positive
+/// values.
+///
+TRestDetectorSignal::Statistics TRestDetectorSignal::ComputeStatistics(Int_t baseLineStart,
+                                                                       Int_t baseLineEnd) const {
+    Statistics statistics;
+
+    const Int_t nPoints = GetNumberOfPoints();
+    if (nPoints == 0) {
+        return statistics;
+    }
+
+    if (baseLineStart < 0) baseLineStart = 0;
+    if (baseLineEnd > nPoints) baseLineEnd = nPoints;
+
+    // The charge values are accessed directly when they are stored as doubles
+    const Double_t* charge = HasADCStorage() ? nullptr : fSignalCharge.data();
+
+    Double_t maxValue = GetData(0);
+    Double_t minValue = GetData(0);
+    Int_t maxIndex = 0;
+    Int_t minIndex = 0;
+    Double_t integral = 0;
+    for (int i = 0; i < nPoints; i++) {
+        const Double_t value = charge ? charge[i] : GetData(i);
+        integral += value;
+        if (value > maxValue) {
+            maxValue = value;
+            maxIndex = i;
+        }
+        if (value < minValue) {
+            minValue = value;
+            minIndex = i;
+        }
+    }
+
+    // The baseline accumulations are shifted by the first value to reduce rounding errors
+    const Double_t shift = baseLineStart < baseLineEnd ? GetData(baseLineStart) : 0;
+    Double_t baseLineSum = 0;
+    Double_t baseLineSum2 = 0;
+    for (int i = baseLineStart; i < baseLineEnd; i++) {
+        const Double_t value = (charge ? charge[i] : GetData(i)) - shift;
+        baseLineSum += value;
+        baseLineSum2 += value * value;
+    }
+
+    // The times are sorted unless they are stored explicitly
+    Double_t minTime = GetTime(0);
+    Double_t maxTime = GetTime(nPoints - 1);
+    if (!HasImplicitTimeAxis()) {
+        const auto [first, last] = std::minmax_element(fSignalTime.begin(), fSignalTime.end());
+        minTime = *first;
+        maxTime = *last;
+    }
+
+    statistics.maxValue = maxValue;
+    statistics.minValue = minValue;
+    statistics.maxIndex = maxIndex;
+    statistics.minIndex = minIndex;
+    statistics.integral = integral;
+
+    if (baseLineEnd - baseLineStart > 0) {
+        const Double_t n = baseLineEnd - baseLineStart;
+        const Double_t mean = baseLineSum / n;
+        statistics.baseLine = shift + mean;
+        statistics.baseLineSigma = TMath::Sqrt(std::max(0., baseLineSum2 / n - mean * mean));
+    }
+
+    statistics.minTime = minTime;
+    statistics.maxTime = maxTime;
+
+    return statistics;
+}
+
 Double_t TRestDetectorSignal::GetBaseLine(Int_t startBin, Int_t endBin) {
     if (endBin - startBin <= 0) return 0.;
 
     Double_t baseLine = 0;
-    for (int i = startBin; i < endBin; i++) baseLine += fSignalCharge[i];
+    for (int i = startBin; i < endBin; i++) baseLine += GetData(i);
 
     return baseLine / (endBin - startBin);
 }
@@ -591,7 +1375,7 @@ Double_t TRestDetectorSignal::GetBaseLineSigma(Int_t startBin, Int_t endBin, Dou
 
     Double_t baseLineSigma = 0;
     for (int i = startBin; i < endBin; i++)
-        baseLineSigma += (bL - fSignalCharge[i]) * (bL - fSignalCharge[i]);
+        baseLineSigma += (bL - GetData(i)) * (bL - GetData(i));
 
     return TMath::Sqrt(baseLineSigma / (endBin - startBin));
 }
@@ -605,18 +1389,35 @@ Double_t TRestDetectorSignal::SubstractBaseline(Int_t startBin, Int_t endBin) {
 }
 
 void TRestDetectorSignal::AddOffset(Double_t offset) {
-    for (int i = 0; i < GetNumberOfPoints(); i++) fSignalCharge[i] = fSignalCharge[i] + offset;
+    InvalidateEventExtrema();
+    SetDoubleStorage();
+
+    const Int_t nPoints = GetNumberOfPoints();
+    Double_t* charge = fSignalCharge.data();
+    for (int i = 0; i < nPoints; i++) {
+        charge[i] += offset;
+    }
 }
 
 void TRestDetectorSignal::MultiplySignalBy(Double_t factor) {
-    for (int i = 0; i < GetNumberOfPoints(); i++) fSignalCharge[i] = factor * fSignalCharge[i];
+    InvalidateEventExtrema();
+    SetDoubleStorage();
+
+    // A plain loop over the charge values, that the compiler can vectorize
+    const Int_t nPoints = GetNumberOfPoints();
+    Double_t* charge = fSignalCharge.data();
+    for (int i = 0; i < nPoints; i++) {
+        charge[i] *= factor;
+    }
 }
 
 void TRestDetectorSignal::ExponentialConvolution(Double_t fromTime, Double_t decayTime, Double_t offset) {
+    InvalidateEventExtrema();
+    SetDoubleStorage();
     for (int i = 0; i < GetNumberOfPoints(); i++) {
-        if (fSignalTime[i] > fromTime) {
+        if (GetTime(i) > fromTime) {
             fSignalCharge[i] =
-                (fSignalCharge[i] - offset) * exp(-(fSignalTime[i] - fromTime) / decayTime) + offset;
+                (fSignalCharge[i] - offset) * exp(-(GetTime(i) - fromTime) / decayTime) + offset;
         }
     }
 }
@@ -640,6 +1441,8 @@ void TRestDetectorSignal::SignalAddition(TRestDetectorSignal* inSignal) {
         return;
     }
 
+    InvalidateEventExtrema();
+    SetDoubleStorage();
     for (int i = 0; i < GetNumberOfPoints(); i++) fSignalCharge[i] += inSignal->GetData(i);
 }
 
@@ -658,46 +1461,99 @@ void TRestDetectorSignal::AddGaussianSignal(Double_t amp, Double_t sigma, Double
 void TRestDetectorSignal::GetWhiteNoiseSignal(TRestDetectorSignal* noiseSignal, Double_t noiseLevel) {
     this->Sort();
 
+    TRandom3 random(0);
     for (int i = 0; i < GetNumberOfPoints(); i++) {
-        TRandom3* fRandom = new TRandom3(0);
-
-        noiseSignal->IncreaseAmplitude(GetTime(i), GetData(i) + fRandom->Gaus(0, noiseLevel));
-
-        delete fRandom;
+        noiseSignal->IncreaseAmplitude(GetTime(i), GetData(i) + random.Gaus(0, noiseLevel));
     }
 }
 
+///////////////////////////////////////////////
+/// \brief It convolutes the signal with a gaussian of width `sigma` and writes the
+/// result into `convSignal`.
+///
+/// The output is defined on a unit-step time grid. Each input point at time t
+/// contributes to the output bin [i, i+1) with the gaussian integral over the bin,
+/// which is obtained analytically as a difference of error functions. The kernel
+/// values only depend on the offset between the output bin and the input point, so
+/// they are precomputed into a table that is re-used for every input point sharing
+/// the same fractional time (i.e. all the points of a uniformly sampled signal).
+///
+/// The convolution is truncated at `nSigmas` from each input point, and it is
+/// accumulated into a dense output buffer that is transferred to `convSignal` at
+/// the end.
+///
 void TRestDetectorSignal::GetSignalGaussianConvolution(TRestDetectorSignal* convSignal, Double_t sigma,
                                                        Int_t nSigmas) {
     this->Sort();
 
-    Int_t nPoints = GetMaxTime() - GetMinTime();
-    TF1* fGaus = new TF1("fGauss", "exp(-0.5*((x-[1])/[2])**2)", -nPoints, nPoints);
-    sigma = sigma * 1000.;          // conversion to nanoseconds
-    fGaus->SetParameter(2, sigma);  // the width of the gaussian is set
+    if (GetNumberOfPoints() == 0) {
+        return;
+    }
+
+    sigma = sigma * 1000.;  // conversion to nanoseconds
+    const Double_t range = nSigmas * sigma;
+    const Double_t norm = 1. / (TMath::Sqrt(2.) * sigma);
 
-    Double_t totChargeInitial = 0.;
-    Double_t totChargeFinal = 0.;
+    // Same output bins as the original TF1 based implementation
+    const Int_t firstBin = static_cast<Int_t>(GetMinTime() - range);
+    const Int_t nBins = std::max(0, (Int_t)TMath::Ceil(GetMaxTime() + range - firstBin));
 
-    Double_t sum;
+    std::vector<Double_t> output(nBins, 0.);
+    std::vector<bool> filled(nBins, false);
 
-    // We calculate the charge of the event before convolution
-    for (int i = 0; i < GetNumberOfPoints(); i++) totChargeInitial += fSignalCharge[i];
+    std::vector<Double_t> kernel;
+    Int_t kernelFirst = 0;
+    Double_t kernelFraction = std::numeric_limits<Double_t>::quiet_NaN();
 
-    // The gaussian convolution of the initial signal is performed
-    for (int i = GetMinTime() - nSigmas * sigma; i < GetMaxTime() + nSigmas * sigma; i++) {
-        for (int j = 0; j < GetNumberOfPoints(); j++) {
-            if (TMath::Abs(i - GetTime(j)) > nSigmas * sigma) continue;
-            if (TMath::Abs(i - GetTime(j)) > nSigmas * sigma && i < GetTime(j)) break;
+    Double_t totChargeInitial = 0.;
+    Double_t totChargeFinal = 0.;
 
-            fGaus->SetParameter(1, GetTime(j));
-            sum = fSignalCharge[j] / TMath::Sqrt(2. * TMath::Pi()) / sigma * fGaus->Integral(i, i + 1);
+    for (int j = 0; j < GetNumberOfPoints(); j++) {
+        const Double_t time = GetTime(j);
+        const Double_t charge = GetData(j);
+        totChargeInitial += charge;
+
+        const Double_t base = TMath::Floor(time);
+        const Double_t fraction = time - base;
+
+        // The kernel is only re-computed when the fractional time changes
+        if (fraction != kernelFraction) {
+            kernelFraction = fraction;
+            kernelFirst = static_cast<Int_t>(TMath::Ceil(fraction - range));
+            const Int_t kernelLast = static_cast<Int_t>(TMath::Floor(fraction + range));
+
+            kernel.resize(kernelLast - kernelFirst + 1);
+            Double_t low = TMath::Erf((kernelFirst - fraction) * norm);
+            for (size_t k = 0; k < kernel.size(); k++) {
+                const Double_t high = TMath::Erf((kernelFirst + (Int_t)k + 1 - fraction) * norm);
+                kernel[k] = 0.5 * (high - low);
+                low = high;
+            }
+        }
 
-            convSignal->IncreaseAmplitude(i, sum);
+        const Int_t offset = static_cast<Int_t>(base) + kernelFirst - firstBin;
+        const Int_t from = std::max(0, -offset);
+        const Int_t to = std::min((Int_t)kernel.size(), nBins - offset);
+        for (int k = from; k < to; k++) {
+            const Double_t sum = charge * kernel[k];
+            output[offset + k] += sum;
+            filled[offset + k] = true;
             totChargeFinal += sum;
         }
     }
 
+    const bool empty = convSignal->GetNumberOfPoints() == 0;
+    for (int n = 0; n < nBins; n++) {
+        if (!filled[n]) {
+            continue;
+        }
+        if (empty) {
+            convSignal->NewPoint(firstBin + n, output[n]);
+        } else {
+            convSignal->IncreaseAmplitude(firstBin + n, output[n]);
+        }
+    }
+
     cout << "Initial charge of the pulse " << totChargeInitial << endl;
     cout << "Final charge of the pulse " << totChargeFinal << endl;
 }
@@ -728,6 +1584,17 @@ void TRestDetectorSignal::Print() const {
     cout << "================================================" << endl;
 }
 
+///////////////////////////////////////////////
+/// \brief It returns a new graph with the signal points, owned by the caller.
+///
+std::unique_ptr<TGraph> TRestDetectorSignal::NewGraph() const {
+    auto graph = std::make_unique<TGraph>(GetNumberOfPoints());
+    for (int n = 0; n < GetNumberOfPoints(); n++) {
+        graph->SetPoint(n, GetTime(n), GetData(n));
+    }
+    return graph;
+}
+
 TGraph* TRestDetectorSignal::GetGraph(Int_t color) {
     if (fGraph != nullptr) {
         delete fGraph;
@@ -109,9 +109,7 @@ TRestDetectorSignalChannelActivityProcess::TRestDetectorSignalChannelActivityPro
 ///////////////////////////////////////////////
 /// \brief Default destructor
 ///
-TRestDetectorSignalChannelActivityProcess::~TRestDetectorSignalChannelActivityProcess() {
-    delete fSignalEvent;
-}
+TRestDetectorSignalChannelActivityProcess::~TRestDetectorSignalChannelActivityProcess() {}
 
 ///////////////////////////////////////////////
 /// \brief Function to load the default config in absence of RML input
@@ -126,7 +124,7 @@ void TRestDetectorSignalChannelActivityProcess::Initialize() {
     SetSectionName(this->ClassName());
     SetLibraryVersion(LIBRARY_VERSION);
 
-    fSignalEvent = new TRestDetectorSignalEvent();
+    fSignalEvent = nullptr;
 }
 
 ///////////////////////////////////////////////
@@ -201,29 +199,21 @@ void TRestDetectorSignalChannelActivityProcess::InitProcess() {
 TRestEvent* TRestDetectorSignalChannelActivityProcess::ProcessEvent(TRestEvent* inputEvent) {
     TString obsName;
 
-    TRestDetectorSignalEvent* fInputSignalEvent = (TRestDetectorSignalEvent*)inputEvent;
-
-    /// Copying the signal event to the output event
-
-    fSignalEvent->SetID(fInputSignalEvent->GetID());
-    fSignalEvent->SetSubID(fInputSignalEvent->GetSubID());
-    fSignalEvent->SetTimeStamp(fInputSignalEvent->GetTimeStamp());
-    fSignalEvent->SetSubEventTag(fInputSignalEvent->GetSubEventTag());
+    // The input event is only read, so it is analyzed in place and passed through unchanged
+    fSignalEvent = (TRestDetectorSignalEvent*)inputEvent;
 
-    Int_t N = fInputSignalEvent->GetNumberOfSignals();
-    for (int sgnl = 0; sgnl < N; sgnl++) fSignalEvent->AddSignal(*fInputSignalEvent->GetSignal(sgnl));
-    /////////////////////////////////////////////////
+    Int_t N = fSignalEvent->GetNumberOfSignals();
 
+    // The maximum of each signal is evaluated only once
+    fSignalEvent->ComputeStatistics(fStatistics);
     Int_t Nlow = 0;
     Int_t Nhigh = 0;
-    for (int s = 0; s < fSignalEvent->GetNumberOfSignals(); s++) {
-        TRestDetectorSignal* sgnl = fSignalEvent->GetSignal(s);
-        if (sgnl->GetMaxValue() > fHighThreshold) Nhigh++;
-        if (sgnl->GetMaxValue() > fLowThreshold) Nlow++;
+    for (int s = 0; s < N; s++) {
+        if (fStatistics[s].maxValue > fHighThreshold) Nhigh++;
+        if (fStatistics[s].maxValue > fLowThreshold) Nlow++;
     }
 
-    for (int s = 0; s < fSignalEvent->GetNumberOfSignals(); s++) {
-        TRestDetectorSignal* sgnl = fSignalEvent->GetSignal(s);
+    for (int s = 0; s < N; s++) {
         // Adding signal to the channel activity histogram
         if (!fReadOnly && fReadout) {
             Int_t signalID = fSignalEvent->GetSignal(s)->GetID();
@@ -233,14 +223,14 @@ TRestEvent* TRestDetectorSignalChannelActivityProcess::ProcessEvent(TRestEvent*
 
             fReadoutChannelsHisto->Fill(readoutChannel);
 
-            if (sgnl->GetMaxValue() > fLowThreshold) {
+            if (fStatistics[s].maxValue > fLowThreshold) {
                 if (Nlow == 1) fReadoutChannelsHisto_OneSignal->Fill(readoutChannel);
                 if (Nlow == 2) fReadoutChannelsHisto_TwoSignals->Fill(readoutChannel);
                 if (Nlow == 3) fReadoutChannelsHisto_ThreeSignals->Fill(readoutChannel);
                 if (Nlow > 3 && Nlow < 10) fReadoutChannelsHisto_MultiSignals->Fill(readoutChannel);
             }
 
-            if (sgnl->GetMaxValue() > fHighThreshold) {
+            if (fStatistics[s].maxValue > fHighThreshold) {
                 if (Nhigh == 1) fReadoutChannelsHisto_OneSignal_High->Fill(readoutChannel);
                 if (Nhigh == 2) fReadoutChannelsHisto_TwoSignals_High->Fill(readoutChannel);
                 if (Nhigh == 3) fReadoutChannelsHisto_ThreeSignals_High->Fill(readoutChannel);
@@ -21,7 +21,16 @@
 
 #include "TRestDetectorSignalEvent.h"
 
+#include <Math/MinimizerOptions.h>
 #include <TMath.h>
+#include <TROOT.h>
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+#include "TRestDetectorReadout.h"
 
 using namespace std;
 
@@ -36,16 +45,79 @@ TRestDetectorSignalEvent::~TRestDetectorSignalEvent() {
     // TRestDetectorSignalEvent destructor
 }
 
+///////////////////////////////////////////////
+/// \brief It clears the event contents.
+///
+/// The signals are not destroyed but kept in a pool, and they are re-used by the
+/// signals added later on. Since the signals keep their allocated buffers, filling
+/// events of similar size does not require any new memory allocation. See
+/// ReleaseSignals.
+///
 void TRestDetectorSignalEvent::Initialize() {
     TRestEvent::Initialize();
-    fSignal.clear();
+    ReleaseSignals(0);
+    fSignalLabels.clear();
+    fSignalLabelIds.clear();
     fPad = nullptr;
+    InvalidateExtrema();
     fMinValue = std::numeric_limits<Double_t>::max();
     fMaxValue = std::numeric_limits<Double_t>::min();
     fMinTime = std::numeric_limits<Double_t>::max();
     fMaxTime = std::numeric_limits<Double_t>::min();
 }
 
+///////////////////////////////////////////////
+/// \brief It removes the signals from the given index to the end, keeping them at
+/// the pool to be re-used by NewSignal.
+///
+/// The pool never holds more signals than the largest number of signals released at
+/// once, so that it does not grow when the signals are added by other means than
+/// NewSignal, e.g. moved into the event or read from a file.
+///
+void TRestDetectorSignalEvent::ReleaseSignals(size_t first) {
+    if (first >= fSignal.size()) {
+        return;
+    }
+
+    fSignalPoolLimit = std::max(fSignalPoolLimit, fSignal.size() - first);
+    for (size_t n = first; n < fSignal.size() && fSignalPool.size() < fSignalPoolLimit; n++) {
+        fSignalPool.push_back(std::move(fSignal[n]));
+    }
+    fSignal.resize(first);
+    InvalidateExtrema();
+}
+
+///////////////////////////////////////////////
+/// \brief It appends an empty signal to the event, re-using a signal from the
+/// pool when available.
+///
+TRestDetectorSignal& TRestDetectorSignalEvent::NewSignal() {
+    InvalidateExtrema();
+    if (fSignalPool.empty()) {
+        fSignal.emplace_back();
+    } else {
+        fSignal.push_back(std::move(fSignalPool.back()));
+        fSignalPool.pop_back();
+    }
+
+    // Points are cleared keeping the allocated memory
+    TRestDetectorSignal& signal = fSignal.back();
+    signal.Reset();
+    signal.fTimeStep = 0;
+    signal.fSignalID = -1;
+    signal.fNameId = -1;
+    signal.fTypeId = -1;
+    signal.fLabels.clear();
+    signal.fPointsOverThreshold.clear();
+    signal.fEvent = this;
+
+    return signal;
+}
+
+///////////////////////////////////////////////
+/// \brief It adds a copy of the given signal to the event. The copy re-uses the
+/// buffers of a previously released signal when available.
+///
 void TRestDetectorSignalEvent::AddSignal(const TRestDetectorSignal& signal) {
     if (signalIDExists(signal.GetSignalID())) {
         cout << "Warning. Signal ID : " << signal.GetSignalID()
@@ -53,7 +125,123 @@ void TRestDetectorSignalEvent::AddSignal(const TRestDetectorSignal& signal) {
         return;
     }
 
-    fSignal.emplace_back(signal);
+    // The copy re-uses the capacity of the pooled signal vectors, and keeps its own graph
+    TRestDetectorSignal& added = NewSignal();
+    added.CopyPoints(signal);
+
+    // The labels are moved from the dictionary of the source signal into the event dictionary
+    added.fNameId = InternSignalLabel(signal.GetSignalName());
+    added.fTypeId = InternSignalLabel(signal.GetSignalType());
+}
+
+///////////////////////////////////////////////
+/// \brief It moves the given signal into the event, avoiding the copy of its points.
+///
+/// The signal brings its own buffers, so one of the pooled signals is released to keep
+/// the number of allocated signals constant.
+///
+void TRestDetectorSignalEvent::AddSignal(TRestDetectorSignal&& signal) {
+    if (signalIDExists(signal.GetSignalID())) {
+        cout << "Warning. Signal ID : " << signal.GetSignalID()
+             << " already exists. Signal will not be added to signal event" << endl;
+        return;
+    }
+
+    InvalidateExtrema();
+    if (!fSignalPool.empty()) {
+        fSignalPool.pop_back();
+    }
+
+    const std::string name = signal.GetSignalName();
+    const std::string type = signal.GetSignalType();
+
+    fSignal.push_back(std::move(signal));
+
+    TRestDetectorSignal& added = fSignal.back();
+    added.fEvent = this;
+    added.fLabels.clear();
+    added.fNameId = InternSignalLabel(name);
+    added.fTypeId = InternSignalLabel(type);
+}
+
+///////////////////////////////////////////////
+/// \brief It replaces the signals of this event by copies of the signals of the
+/// given event, re-using the buffers of the released signals.
+///
+/// The signal ids of an event are unique, so the signals are copied without the
+/// duplicate check of AddSignal. The labels dictionary and the readout are copied
+/// as well, so that the label ids of the copies remain valid. The event information
+/// is not modified.
+///
+void TRestDetectorSignalEvent::CopySignals(const TRestDetectorSignalEvent& event) {
+    if (&event == this) {
+        return;
+    }
+
+    ReleaseSignals(0);
+    fSignalLabels = event.fSignalLabels;
+    fSignalLabelIds.clear();
+    fReadout = event.fReadout;
+
+    fSignal.reserve(event.fSignal.size());
+    for (const auto& signal : event.fSignal) {
+        TRestDetectorSignal& added = NewSignal();
+        added.CopyPoints(signal);
+        if (signal.fLabels.empty()) {
+            added.fNameId = signal.fNameId;
+            added.fTypeId = signal.fTypeId;
+        } else {
+            // Signals read from an older class version keep their own dictionary
+            added.fNameId = InternSignalLabel(signal.GetSignalName());
+            added.fTypeId = InternSignalLabel(signal.GetSignalType());
+        }
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It registers a signal name or type at the event labels dictionary, so that
+/// each distinct label is stored only once per event. It returns the label id, or -1
+/// for an empty label.
+///
+Int_t TRestDetectorSignalEvent::InternSignalLabel(const std::string& label) {
+    if (label.empty()) {
+        return -1;
+    }
+
+    // The reverse lookup is cleared when a new event is read
+    if (fSignalLabelIds.empty()) {
+        for (size_t n = 0; n < fSignalLabels.size(); n++) {
+            fSignalLabelIds[fSignalLabels[n]] = n;
+        }
+    }
+
+    const auto it = fSignalLabelIds.find(label);
+    if (it != fSignalLabelIds.end()) {
+        return it->second;
+    }
+
+    fSignalLabels.push_back(label);
+    fSignalLabelIds[label] = fSignalLabels.size() - 1;
+    return fSignalLabels.size() - 1;
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the name, or the type if `type` is true, of the readout channel
+/// with the given DAQ id, or an empty string if no readout has been assigned to the
+/// event or the channel does not exist.
+///
+/// It allows the signals created from a readout to be stored without labels, since
+/// their id already identifies the readout channel.
+///
+std::string TRestDetectorSignalEvent::GetReadoutLabel(Int_t signalID, Bool_t type) const {
+    if (fReadout == nullptr) {
+        return "";
+    }
+    TRestDetectorReadoutChannel* channel = fReadout->GetReadoutChannelWithDaqID(signalID);
+    if (channel == nullptr) {
+        return "";
+    }
+    return type ? channel->GetChannelType() : channel->GetChannelName();
 }
 
 void TRestDetectorSignalEvent::RemoveSignalWithId(Int_t sId) {
@@ -66,6 +254,78 @@ void TRestDetectorSignalEvent::RemoveSignalWithId(Int_t sId) {
     }
 
     fSignal.erase(fSignal.begin() + index);
+    InvalidateExtrema();
+}
+
+///////////////////////////////////////////////
+/// \brief It removes every signal without points, keeping the order of the
+/// remaining signals, and returns the number of signals removed. The removed
+/// signals are kept at the pool to be re-used by NewSignal.
+///
+Int_t TRestDetectorSignalEvent::RemoveEmptySignals() {
+    size_t kept = 0;
+    for (size_t n = 0; n < fSignal.size(); n++) {
+        if (fSignal[n].GetNumberOfPoints() == 0) {
+            continue;
+        }
+        if (kept != n) {
+            std::swap(fSignal[kept], fSignal[n]);
+        }
+        kept++;
+    }
+
+    const Int_t removed = fSignal.size() - kept;
+    ReleaseSignals(kept);
+
+    return removed;
+}
+
+///////////////////////////////////////////////
+/// \brief It stores the charge of every signal as 16-bit ADC values together with an
+/// implicit time axis, when the signal points are on a uniform sampling grid, with or
+/// without gaps. See TRestDetectorSignal::SetADCStorage and
+/// TRestDetectorSignal::SetImplicitTimeAxis.
+///
+/// Each point then takes 2 bytes instead of the 16 bytes of its time and charge, plus
+/// 8 bytes per segment of consecutive samples. Signals that cannot use an implicit time
+/// axis still store their times, taking 10 bytes per point.
+///
+/// The charge of each signal is quantized in steps of `quantization`, and the offset
+/// of each channel is centered at its charge range. If the charge range of a signal
+/// does not fit in 16 bits with the given quantization, a coarser scale is used for
+/// that signal.
+///
+/// It returns true if no charge value was modified, which is always the case for
+/// digitized data with the default quantization.
+///
+Bool_t TRestDetectorSignalEvent::SetADCStorage(Double_t quantization) {
+    InvalidateExtrema();
+    Bool_t lossless = true;
+    for (auto& signal : fSignal) {
+        if (signal.GetNumberOfPoints() == 0) {
+            continue;
+        }
+
+        signal.SetImplicitTimeAxis();
+
+        Double_t min = signal.GetData(0);
+        Double_t max = signal.GetData(0);
+        for (int n = 1; n < signal.GetNumberOfPoints(); n++) {
+            min = std::min(min, signal.GetData(n));
+            max = std::max(max, signal.GetData(n));
+        }
+
+        Double_t scale = quantization;
+        if ((max - min) / scale > 65534.) {
+            scale = (max - min) / 65534.;
+        }
+        const Double_t offset = scale * TMath::Nint(0.5 * (max + min) / scale);
+
+        if (!signal.SetADCStorage(scale, offset)) {
+            lossless = false;
+        }
+    }
+    return lossless;
 }
 
 Int_t TRestDetectorSignalEvent::GetSignalIndex(Int_t signalID) {
@@ -93,11 +353,10 @@ void TRestDetectorSignalEvent::AddChargeToSignal(Int_t signalID, Double_t time,
     Int_t signalIndex = GetSignalIndex(signalID);
     if (signalIndex == -1) {
         signalIndex = GetNumberOfSignals();
-        TRestDetectorSignal signal;
-        signal.SetSignalID(signalID);
-        AddSignal(signal);
+        NewSignal().SetSignalID(signalID);
     }
 
+    InvalidateExtrema();
     fSignal[signalIndex].IncreaseAmplitude(time, charge);
 }
 
@@ -105,25 +364,201 @@ void TRestDetectorSignalEvent::PrintEvent() {
     TRestEvent::PrintEvent();
 
     for (int i = 0; i < GetNumberOfSignals(); i++) {
-        const auto& signal = fSignal[i];
-        signal.Print();
+        GetSignal(i)->Print();
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the GetPeaks method corresponding to a method name, or
+/// PeakMethod::Unknown if the name is not valid.
+///
+TRestDetectorSignalEvent::PeakMethod TRestDetectorSignalEvent::ResolvePeakMethod(const std::string& method) {
+    if (method == "gaussFit") return PeakMethod::GaussFit;
+    if (method == "landauFit") return PeakMethod::LandauFit;
+    if (method == "agetFit") return PeakMethod::AgetFit;
+    if (method == "gaussFast") return PeakMethod::GaussFast;
+    if (method == "agetFast") return PeakMethod::AgetFast;
+    return PeakMethod::Unknown;
+}
+
+///////////////////////////////////////////////
+/// \brief It returns true if ROOT fits using the default minimizer may run in
+/// several threads at once. The original Minuit and Fumili implementations keep a
+/// global state, so the fits are only run in threads with other minimizers, e.g.
+/// Minuit2, which is set by `ROOT::Math::MinimizerOptions::SetDefaultMinimizer`.
+///
+Bool_t TRestDetectorSignalEvent::CanFitInThreads() {
+    const std::string minimizer = ROOT::Math::MinimizerOptions::DefaultMinimizerType();
+    return minimizer != "Minuit" && minimizer != "TMinuit" && minimizer != "Fumili" &&
+           minimizer != "TFumili";
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the peak time and amplitude of every signal in the event, in
+/// signal order, using one of the pulse fit methods of TRestDetectorSignal.
+///
+/// The valid methods are `gaussFit`, `landauFit` and `agetFit`, using the ROOT fits
+/// GetPeakGauss, GetPeakLandau and GetPeakAget, and `gaussFast` and `agetFast`, using
+/// the estimators GetPeakGaussFast and GetPeakAgetFast. The fast estimators fall back
+/// to the corresponding ROOT fit if they fail or their relative residual is above
+/// `fastFitTolerance`.
+///
+/// The signals are fitted independently, distributed among `nThreads` threads. Each
+/// fit creates its own function and graph objects. When more than one thread is used,
+/// ROOT thread safety is enabled. The default minimizer is not modified. If it cannot
+/// be used by several threads, see CanFitInThreads, the ROOT fits are done in a single
+/// thread: the fast estimators still run in `nThreads` threads, and only the signals
+/// falling back to a ROOT fit are fitted serially afterwards.
+///
+/// If `selection` is given, only the signals at those positions are fitted, and the
+/// peaks of the other signals are left empty.
+///
+std::vector<std::optional<std::pair<Double_t, Double_t>>> TRestDetectorSignalEvent::GetPeaks(
+    const std::string& method, Int_t nThreads, Double_t fastFitTolerance,
+    const std::vector<Int_t>* selection) {
+    const PeakMethod peakMethod = ResolvePeakMethod(method);
+    if (peakMethod == PeakMethod::Unknown) {
+        throw std::runtime_error("TRestDetectorSignalEvent::GetPeaks. Invalid method: " + method);
+    }
+    return GetPeaks(peakMethod, nThreads, fastFitTolerance, selection);
+}
+
+std::vector<std::optional<std::pair<Double_t, Double_t>>> TRestDetectorSignalEvent::GetPeaks(
+    PeakMethod method, Int_t nThreads, Double_t fastFitTolerance, const std::vector<Int_t>* selection) {
+    if (method == PeakMethod::Unknown) {
+        throw std::runtime_error("TRestDetectorSignalEvent::GetPeaks. Invalid method");
+    }
+
+    std::vector<std::optional<std::pair<Double_t, Double_t>>> peaks(GetNumberOfSignals());
+
+    std::vector<Int_t> allSignals;
+    if (selection == nullptr) {
+        allSignals.resize(GetNumberOfSignals());
+        std::iota(allSignals.begin(), allSignals.end(), 0);
+        selection = &allSignals;
+    }
+    const Int_t nSelected = selection->size();
+
+    const Bool_t isFast = method == PeakMethod::GaussFast || method == PeakMethod::AgetFast;
+    const Bool_t threadedFits = CanFitInThreads();
+
+    auto rootFit = [&](TRestDetectorSignal& signal) -> std::optional<std::pair<Double_t, Double_t>> {
+        switch (method) {
+            case PeakMethod::GaussFit:
+            case PeakMethod::GaussFast:
+                return signal.GetPeakGauss();
+            case PeakMethod::LandauFit:
+                return signal.GetPeakLandau();
+            case PeakMethod::AgetFit:
+            case PeakMethod::AgetFast:
+                return signal.GetPeakAget();
+            default:
+                return std::nullopt;
+        }
+    };
+
+    // It returns false if the signal needs a ROOT fit that could not be done in this thread
+    auto fit = [&](Int_t n, Bool_t canFit) {
+        TRestDetectorSignal& signal = fSignal[n];
+        if (isFast) {
+            Double_t residual = 0;
+            peaks[n] = method == PeakMethod::GaussFast ? signal.GetPeakGaussFast(&residual)
+                                                       : signal.GetPeakAgetFast(&residual);
+            if (peaks[n] && residual <= fastFitTolerance) {
+                return true;
+            }
+        }
+        if (!canFit) {
+            return false;
+        }
+        peaks[n] = rootFit(signal);
+        return true;
+    };
+
+    if (nThreads <= 1 || nSelected < 2 || (!threadedFits && !isFast)) {
+        for (const auto n : *selection) {
+            fit(n, true);
+        }
+        return peaks;
     }
+
+    if (threadedFits) {
+        ROOT::EnableThreadSafety();
+    }
+
+    // Signals are handed out one by one, since the fit time may differ between signals
+    std::vector<char> pending(GetNumberOfSignals(), false);
+    std::atomic<Int_t> next(0);
+    auto worker = [&]() {
+        for (Int_t i = next++; i < nSelected; i = next++) {
+            const Int_t n = (*selection)[i];
+            pending[n] = !fit(n, threadedFits);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < std::min(nThreads, nSelected); t++) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // The fallback fits that could not run in threads
+    for (const auto n : *selection) {
+        if (pending[n]) {
+            peaks[n] = rootFit(fSignal[n]);
+        }
+    }
+
+    return peaks;
 }
 
-// TODO: GetMaxTimeFast, GetMinTimeFast, GetMaxValueFast that return the value of fMinTime, fMaxTime, etc.
+///////////////////////////////////////////////
+/// \brief It fills `statistics` with the result of TRestDetectorSignal::ComputeStatistics
+/// for every signal in the event, in signal order. The vector is resized to the number
+/// of signals, so that it can be re-used between events.
+///
+void TRestDetectorSignalEvent::ComputeStatistics(std::vector<TRestDetectorSignal::Statistics>& statistics,
+                                                 Int_t baseLineStart, Int_t baseLineEnd) const {
+    statistics.resize(fSignal.size());
+    for (size_t n = 0; n < fSignal.size(); n++) {
+        statistics[n] = fSignal[n].ComputeStatistics(baseLineStart, baseLineEnd);
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It updates the minimum and maximum time and value of the event signals.
+///
+/// The values are cached and only recomputed after the event has been modified.
+/// Any method modifying the event or the points of one of its signals invalidates the
+/// cached values, as well as reading a new event into this object. The signals keep a
+/// pointer to the event, so that the modifications through a signal pointer obtained
+/// from GetSignal or GetSignalById are taken into account, even if the pointer is kept
+/// across extrema queries.
+///
 void TRestDetectorSignalEvent::SetMaxAndMin() {
+    if (fExtremaValid) {
+        return;
+    }
+
     fMinValue = std::numeric_limits<Double_t>::max();
     fMaxValue = std::numeric_limits<Double_t>::min();
     fMinTime = std::numeric_limits<Double_t>::max();
     fMaxTime = std::numeric_limits<Double_t>::min();
 
     for (int s = 0; s < GetNumberOfSignals(); s++) {
-        if (fMinTime > fSignal[s].GetMinTime()) fMinTime = fSignal[s].GetMinTime();
-        if (fMaxTime < fSignal[s].GetMaxTime()) fMaxTime = fSignal[s].GetMaxTime();
+        if (fSignal[s].GetNumberOfPoints() == 0) continue;
+        const auto statistics = fSignal[s].ComputeStatistics();
+
+        if (fMinTime > statistics.minTime) fMinTime = statistics.minTime;
+        if (fMaxTime < statistics.maxTime) fMaxTime = statistics.maxTime;
 
-        if (fMinValue > fSignal[s].GetMinValue()) fMinValue = fSignal[s].GetMinValue();
-        if (fMaxValue < fSignal[s].GetMaxValue()) fMaxValue = fSignal[s].GetMaxValue();
+        if (fMinValue > statistics.minValue) fMinValue = statistics.minValue;
+        if (fMaxValue < statistics.maxValue) fMaxValue = statistics.maxValue;
     }
+
+    fExtremaValid = true;
 }
 
 Double_t TRestDetectorSignalEvent::GetMaxValue() {
@@ -137,23 +572,13 @@ Double_t TRestDetectorSignalEvent::GetMinValue() {
 }
 
 Double_t TRestDetectorSignalEvent::GetMinTime() {
-    Double_t minTime = numeric_limits<Double_t>::max();
-    for (int s = 0; s < GetNumberOfSignals(); s++) {
-        if (minTime > fSignal[s].GetMinTime()) {
-            minTime = fSignal[s].GetMinTime();
-        }
-    }
-    return minTime;
+    SetMaxAndMin();
+    return fMinTime;
 }
 
 Double_t TRestDetectorSignalEvent::GetMaxTime() {
-    Double_t maxTime = numeric_limits<Double_t>::min();
-    for (int s = 0; s < GetNumberOfSignals(); s++) {
-        if (maxTime < fSignal[s].GetMaxTime()) {
-            maxTime = fSignal[s].GetMaxTime();
-        }
-    }
-    return maxTime;
+    SetMaxAndMin();
+    return fMaxTime;
 }
 
 // Draw current event in a TPad
@@ -167,11 +592,6 @@ TPad* TRestDetectorSignalEvent::DrawEvent(const TString& option) {
         return nullptr;
     }
 
-    fMinValue = std::numeric_limits<Double_t>::max();
-    fMaxValue = std::numeric_limits<Double_t>::min();
-    fMinTime = std::numeric_limits<Double_t>::max();
-    fMaxTime = std::numeric_limits<Double_t>::min();
-
     fPad = new TPad(this->GetName(), " ", 0, 0, 1, 1);
     fPad->Draw();
     fPad->cd();
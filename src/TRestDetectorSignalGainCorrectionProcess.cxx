@@ -0,0 +1,134 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// This process multiplies the charge of each TRestDetectorSignal by the gain
+/// of its channel, as given by the channel gains of the TRestDetectorGainMap
+/// available to TRestRun. The gain map can be produced with
+/// TRestDetectorSingleChannelAnalysisProcess in create mode.
+///
+/// The channel gains are copied at InitProcess into a table indexed by daq id,
+/// so that the gain of each signal is obtained without any map lookup, and the
+/// charge values of each signal are multiplied in a single pass. The signals of
+/// channels without a recorded gain are multiplied by "defaultGain".
+///
+/// The input event is corrected in place and returned as the output event.
+///
+/// An example of the process definition:
+/// \code
+/// <addProcess type="TRestDetectorSignalGainCorrectionProcess" name="gainCorr" value="ON">
+///     <parameter name="defaultGain" value="1" />
+/// </addProcess>
+/// \endcode
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October First implementation of TRestDetectorSignalGainCorrectionProcess.
+///
+/// \class      TRestDetectorSignalGainCorrectionProcess
+///
+/// <hr>
+///
+
+#include "TRestDetectorSignalGainCorrectionProcess.h"
+
+using namespace std;
+
+ClassImp(TRestDetectorSignalGainCorrectionProcess);
+
+///////////////////////////////////////////////
+/// \brief Default constructor
+///
+TRestDetectorSignalGainCorrectionProcess::TRestDetectorSignalGainCorrectionProcess() { Initialize(); }
+
+///////////////////////////////////////////////
+/// \brief Constructor loading data from a config file
+///
+/// \param configFilename A const char* giving the path to an RML file.
+///
+TRestDetectorSignalGainCorrectionProcess::TRestDetectorSignalGainCorrectionProcess(
+    const char* configFilename) {
+    Initialize();
+
+    LoadConfigFromFile(configFilename);
+}
+
+///////////////////////////////////////////////
+/// \brief Default destructor. The output event is the input event, and it is
+/// not owned by this process.
+///
+TRestDetectorSignalGainCorrectionProcess::~TRestDetectorSignalGainCorrectionProcess() {}
+
+///////////////////////////////////////////////
+/// \brief Function to initialize input/output event members and define the
+/// section name
+///
+void TRestDetectorSignalGainCorrectionProcess::Initialize() {
+    SetSectionName(this->ClassName());
+    SetLibraryVersion(LIBRARY_VERSION);
+
+    fSignalEvent = nullptr;
+    fCalib = nullptr;
+}
+
+///////////////////////////////////////////////
+/// \brief Process initialization. The channel gains are copied into a table
+/// indexed by daq id.
+///
+void TRestDetectorSignalGainCorrectionProcess::InitProcess() {
+    if (fCalib == nullptr) fCalib = GetMetadata<TRestDetectorGainMap>();
+    if (fCalib == nullptr) {
+        RESTError << "You must set a TRestDetectorGainMap metadata object to apply gain correction!"
+                  << RESTendl;
+        abort();
+    }
+
+    fCalib->FillChannelGainTable(fGainTable, fDefaultGain);
+    if (fGainTable.empty()) {
+        RESTWarning << "TRestDetectorSignalGainCorrectionProcess. The gain map does not contain channel gains"
+                    << RESTendl;
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief The main processing event function
+///
+TRestEvent* TRestDetectorSignalGainCorrectionProcess::ProcessEvent(TRestEvent* inputEvent) {
+    fSignalEvent = (TRestDetectorSignalEvent*)inputEvent;
+
+    const Int_t nChannels = fGainTable.size();
+    for (int n = 0; n < fSignalEvent->GetNumberOfSignals(); n++) {
+        TRestDetectorSignal* signal = fSignalEvent->GetSignal(n);
+
+        const Int_t id = signal->GetID();
+        const Double_t gain = (id >= 0 && id < nChannels) ? fGainTable[id] : fDefaultGain;
+        if (gain != 1) {
+            signal->MultiplySignalBy(gain);
+        }
+    }
+
+    return fSignalEvent;
+}
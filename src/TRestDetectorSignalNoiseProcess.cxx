@@ -0,0 +1,323 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// This process adds electronic noise to every TRestDetectorSignal of the
+/// event, with a given RMS and power spectrum. It is intended to produce
+/// realistic signals from the simulated ones, as an alternative to
+/// TRestDetectorSignal::GetWhiteNoiseSignal, that only produces white noise.
+///
+/// The noise is synthesized in the frequency domain. For each signal, the
+/// frequency components are independent gaussian values shaped by a filter
+/// that is calculated once for each number of samples, and the noise series is
+/// obtained with a single fast Fourier transform. The real and imaginary parts
+/// of the transform are two independent noise series, so that one transform is
+/// done for every two signals. The cost per event is proportional to
+/// `nSignals * n log(n)`, being `n` the number of samples between the first
+/// and the last point of the event, rounded up to a power of two.
+///
+/// The noise power spectrum is proportional to `1/f^spectralIndex`, a white
+/// spectrum for the default index 0, optionally multiplied by the response of
+/// a first order low pass filter with the given "cutoffFrequency". The
+/// frequencies are obtained from the "sampling" parameter. The noise RMS is
+/// given by "noiseLevel".
+///
+/// The noise of the channels read by the same chip can be correlated, as it
+/// happens with the noise of a common ground or power supply. The chip of each
+/// signal is given by its daq id divided by "chipChannels", and a fraction
+/// "chipCorrelation" of the noise power is common to all the channels of the
+/// chip.
+///
+/// The noise added to each signal point is the one of its sample, given by the
+/// point time and the "sampling" parameter, counted from the earliest point of
+/// the event. Signals with gaps, as the ones produced by
+/// TRestDetectorSignalZeroSuppressionProcess, get the same noise at each sample
+/// as the complete signal would. A point between sampling times gets the noise
+/// of the nearest sample.
+///
+/// The random generator is seeded for each event from the "seed" parameter and
+/// the event id, so that the noise of each event is reproducible, independently
+/// of the number of threads. If the seed is 0 a random seed is used, and it is
+/// written to the process metadata.
+///
+/// An example of the process definition:
+/// \code
+/// <addProcess type="TRestDetectorSignalNoiseProcess" name="noise" value="ON">
+///     <parameter name="noiseLevel" value="10" />
+///     <parameter name="spectralIndex" value="1" />
+///     <parameter name="cutoffFrequency" value="5" units="MHz" />
+///     <parameter name="sampling" value="0.04" units="us" />
+///     <parameter name="chipChannels" value="64" />
+///     <parameter name="chipCorrelation" value="0.3" />
+///     <parameter name="seed" value="17" />
+/// </addProcess>
+/// \endcode
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October First implementation of TRestDetectorSignalNoiseProcess.
+///
+/// \class      TRestDetectorSignalNoiseProcess
+///
+/// <hr>
+///
+
+#include "TRestDetectorSignalNoiseProcess.h"
+
+#include <TMath.h>
+
+#include <map>
+
+using namespace std;
+
+ClassImp(TRestDetectorSignalNoiseProcess);
+
+///////////////////////////////////////////////
+/// \brief Default constructor
+///
+TRestDetectorSignalNoiseProcess::TRestDetectorSignalNoiseProcess() { Initialize(); }
+
+///////////////////////////////////////////////
+/// \brief Constructor loading data from a config file
+///
+/// \param configFilename A const char* giving the path to an RML file.
+///
+TRestDetectorSignalNoiseProcess::TRestDetectorSignalNoiseProcess(const char* configFilename) {
+    Initialize();
+
+    if (LoadConfigFromFile(configFilename) == -1) {
+        LoadDefaultConfig();
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief Default destructor. The output event is the input event, and it is
+/// not owned by this process.
+///
+TRestDetectorSignalNoiseProcess::~TRestDetectorSignalNoiseProcess() { delete fRandom; }
+
+///////////////////////////////////////////////
+/// \brief Function to load the default config in absence of RML input
+///
+void TRestDetectorSignalNoiseProcess::LoadDefaultConfig() {
+    SetName("signalNoiseProcess-Default");
+    SetTitle("Default config");
+
+    fNoiseLevel = 1.;
+    fSpectralIndex = 0.;
+    fCutoffFrequency = 0.;
+    fSampling = 1.;
+    fChipChannels = 0;
+    fChipCorrelation = 0.;
+}
+
+///////////////////////////////////////////////
+/// \brief Function to initialize input/output event members and define the
+/// section name
+///
+void TRestDetectorSignalNoiseProcess::Initialize() {
+    SetSectionName(this->ClassName());
+    SetLibraryVersion(LIBRARY_VERSION);
+
+    fSignalEvent = nullptr;
+}
+
+///////////////////////////////////////////////
+/// \brief Process initialization. The random seed is fixed, and the filter will
+/// be calculated for the number of samples of the first event.
+///
+void TRestDetectorSignalNoiseProcess::InitProcess() {
+    delete fRandom;
+    fRandom = new TRandom3(fSeed);
+    fSeed = fRandom->TRandom::GetSeed();
+
+    if (fChipCorrelation < 0 || fChipCorrelation > 1) {
+        RESTError << "TRestDetectorSignalNoiseProcess. The chip correlation must be between 0 and 1"
+                  << RESTendl;
+        fChipCorrelation = TMath::Min(TMath::Max(fChipCorrelation, 0.), 1.);
+    }
+
+    if (fSampling <= 0) {
+        RESTError << "TRestDetectorSignalNoiseProcess. The sampling time must be positive" << RESTendl;
+        fSampling = 1.;
+    }
+
+    fFilter.clear();
+}
+
+///////////////////////////////////////////////
+/// \brief It calculates the amplitude of each frequency component for a noise
+/// series with `size` samples, normalized to produce the requested noise RMS.
+///
+void TRestDetectorSignalNoiseProcess::BuildFilter(Int_t size) {
+    fFilter.resize(size);
+    fSpectrum.resize(size);
+
+    Double_t power = 0;
+    for (int k = 0; k < size; k++) {
+        // Negative frequencies are found at the second half
+        const Double_t frequency = TMath::Min(k, size - k) / (size * fSampling);
+
+        Double_t amplitude = 1;
+        if (fSpectralIndex != 0) {
+            amplitude = frequency > 0 ? TMath::Power(frequency, -fSpectralIndex / 2) : 0;
+        }
+        if (fCutoffFrequency > 0) {
+            amplitude /= TMath::Sqrt(1 + (frequency / fCutoffFrequency) * (frequency / fCutoffFrequency));
+        }
+
+        fFilter[k] = amplitude;
+        power += amplitude * amplitude;
+    }
+
+    // Each part of the transform of the shaped components has a variance equal to the total power
+    const Double_t scale = power > 0 ? fNoiseLevel / TMath::Sqrt(power) : 0;
+    for (auto& amplitude : fFilter) {
+        amplitude *= scale;
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief In-place radix-2 fast Fourier transform. The size of the data must
+/// be a power of two.
+///
+void TRestDetectorSignalNoiseProcess::FFT(std::vector<std::complex<Double_t>>& data) {
+    const size_t n = data.size();
+
+    // Bit reversal permutation
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            swap(data[i], data[j]);
+        }
+    }
+
+    for (size_t length = 2; length <= n; length <<= 1) {
+        const complex<Double_t> root = polar(1., 2 * TMath::Pi() / length);
+        for (size_t i = 0; i < n; i += length) {
+            complex<Double_t> w = 1;
+            for (size_t j = 0; j < length / 2; j++) {
+                const complex<Double_t> u = data[i + j];
+                const complex<Double_t> v = data[i + j + length / 2] * w;
+                data[i + j] = u + v;
+                data[i + j + length / 2] = u - v;
+                w *= root;
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief The main processing event function
+///
+TRestEvent* TRestDetectorSignalNoiseProcess::ProcessEvent(TRestEvent* inputEvent) {
+    fSignalEvent = (TRestDetectorSignalEvent*)inputEvent;
+
+    const Int_t nSignals = fSignalEvent->GetNumberOfSignals();
+
+    Int_t nPoints = 0;
+    for (int n = 0; n < nSignals; n++) {
+        nPoints = TMath::Max(nPoints, fSignalEvent->GetSignal(n)->GetNumberOfPoints());
+    }
+    if (nPoints == 0) {
+        return fSignalEvent;
+    }
+
+    // The noise series are indexed by sample, starting at the earliest point of the event
+    const Double_t minTime = fSignalEvent->GetMinTime();
+    const Int_t nSamples = TMath::Nint((fSignalEvent->GetMaxTime() - minTime) / fSampling) + 1;
+
+    Int_t size = 1;
+    while (size < nSamples) {
+        size *= 2;
+    }
+    if (size != (Int_t)fFilter.size()) {
+        BuildFilter(size);
+    }
+
+    // The chip rows are placed after the signal rows
+    const Bool_t correlated = fChipChannels > 0 && fChipCorrelation > 0;
+    Int_t nChips = 0;
+    if (correlated) {
+        map<Int_t, Int_t> chips;
+        fChipIndex.resize(nSignals);
+        for (int n = 0; n < nSignals; n++) {
+            const Int_t chip = fSignalEvent->GetSignal(n)->GetID() / fChipChannels;
+            fChipIndex[n] = chips.emplace(chip, chips.size()).first->second;
+        }
+        nChips = chips.size();
+    }
+
+    // The noise of each event only depends on the seed and the event id. A seed of 0 would be random.
+    const ULong_t seed = fSeed + 1000003 * (ULong_t)fSignalEvent->GetID() + fSignalEvent->GetSubID();
+    fRandom->SetSeed(seed != 0 ? seed : 1);
+
+    const Int_t nSeries = nSignals + nChips;
+    fNoise.resize((size_t)nSeries * size);
+    for (int s = 0; s < nSeries; s += 2) {
+        for (int k = 0; k < size; k++) {
+            Double_t real, imaginary;
+            fRandom->Rannor(real, imaginary);
+            fSpectrum[k] = fFilter[k] * complex<Double_t>(real, imaginary);
+        }
+
+        FFT(fSpectrum);
+
+        Double_t* first = &fNoise[(size_t)s * size];
+        for (int i = 0; i < size; i++) {
+            first[i] = fSpectrum[i].real();
+        }
+        if (s + 1 < nSeries) {
+            Double_t* second = &fNoise[(size_t)(s + 1) * size];
+            for (int i = 0; i < size; i++) {
+                second[i] = fSpectrum[i].imag();
+            }
+        }
+    }
+
+    const Double_t own = correlated ? TMath::Sqrt(1 - fChipCorrelation) : 1;
+    const Double_t common = correlated ? TMath::Sqrt(fChipCorrelation) : 0;
+    for (int n = 0; n < nSignals; n++) {
+        TRestDetectorSignal* signal = fSignalEvent->GetSignal(n);
+        const Double_t* noise = &fNoise[(size_t)n * size];
+        const Double_t* chipNoise = correlated ? &fNoise[(size_t)(nSignals + fChipIndex[n]) * size] : nullptr;
+
+        for (int i = 0; i < signal->GetNumberOfPoints(); i++) {
+            const Int_t sample = TMath::Nint((signal->GetTime(i) - minTime) / fSampling);
+            Double_t value = own * noise[sample];
+            if (chipNoise) {
+                value += common * chipNoise[sample];
+            }
+            signal->IncreaseTimeBinBy(i, value);
+        }
+    }
+
+    return fSignalEvent;
+}
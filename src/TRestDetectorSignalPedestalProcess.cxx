@@ -0,0 +1,261 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// This process keeps a running estimation of the pedestal and noise of each
+/// daq channel across events, and subtracts the pedestal from each
+/// TRestDetectorSignal.
+///
+/// Instead of obtaining the baseline of each signal from a fixed range of
+/// points, as done by TRestDetectorSignal::SubstractBaseline, every point of
+/// the signal that is compatible with the current pedestal, within
+/// "pointThreshold" noise sigmas, contributes to the estimation. The pedestal
+/// and noise variance of each channel are exponential moving averages of the
+/// event values, with a "timeConstant" given in number of events. Therefore,
+/// the estimation is precise even for short acquisition windows, and it follows
+/// slow drifts of the pedestal.
+///
+/// Since only the points within "pointThreshold" sigmas are used, the variance of
+/// the accepted points is smaller than the noise variance. It is divided by the
+/// variance of a gaussian truncated at "pointThreshold" sigmas, 0.973 for the
+/// default of 3 sigmas, so that the noise estimation is not biased low.
+///
+/// The first time a channel is found, its pedestal and noise are initialized
+/// with the median of the signal points and their median absolute deviation,
+/// that are not biased by the pulses of the signal. The initial values are then
+/// refined with the points of the same event.
+///
+/// The estimators are stored in arrays indexed by daq id, and each signal is
+/// processed with a single pass over its points, followed by the pedestal
+/// subtraction if "subtractPedestal" is true. When the processing runs in
+/// several threads, each thread keeps its own estimators.
+///
+/// The following observables are defined, for online monitoring:
+/// * **pedestal_map**: The pedestal of each channel found in the event.
+/// * **noise_map**: The noise sigma of each channel found in the event.
+/// * **meanNoise**: The average noise sigma of the channels found in the event.
+///
+/// An example of the process definition:
+/// \code
+/// <addProcess type="TRestDetectorSignalPedestalProcess" name="pedestal" value="ON">
+///     <parameter name="timeConstant" value="100" />
+///     <parameter name="pointThreshold" value="3" />
+///     <parameter name="subtractPedestal" value="true" />
+///     <observable name="meanNoise" value="ON" />
+/// </addProcess>
+/// \endcode
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October First implementation of TRestDetectorSignalPedestalProcess.
+///
+/// \class      TRestDetectorSignalPedestalProcess
+///
+/// <hr>
+///
+
+#include "TRestDetectorSignalPedestalProcess.h"
+
+#include <TMath.h>
+
+#include <algorithm>
+
+using namespace std;
+
+ClassImp(TRestDetectorSignalPedestalProcess);
+
+///////////////////////////////////////////////
+/// \brief Default constructor
+///
+TRestDetectorSignalPedestalProcess::TRestDetectorSignalPedestalProcess() { Initialize(); }
+
+///////////////////////////////////////////////
+/// \brief Constructor loading data from a config file
+///
+/// \param configFilename A const char* giving the path to an RML file.
+///
+TRestDetectorSignalPedestalProcess::TRestDetectorSignalPedestalProcess(const char* configFilename) {
+    Initialize();
+
+    if (LoadConfigFromFile(configFilename) == -1) {
+        LoadDefaultConfig();
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief Default destructor. The output event is the input event, and it is
+/// not owned by this process.
+///
+TRestDetectorSignalPedestalProcess::~TRestDetectorSignalPedestalProcess() {}
+
+///////////////////////////////////////////////
+/// \brief Function to load the default config in absence of RML input
+///
+void TRestDetectorSignalPedestalProcess::LoadDefaultConfig() {
+    SetName("signalPedestalProcess-Default");
+    SetTitle("Default config");
+
+    fTimeConstant = 100.;
+    fPointThreshold = 3.;
+    fSubtractPedestal = true;
+}
+
+///////////////////////////////////////////////
+/// \brief Function to initialize input/output event members and define the
+/// section name
+///
+void TRestDetectorSignalPedestalProcess::Initialize() {
+    SetSectionName(this->ClassName());
+    SetLibraryVersion(LIBRARY_VERSION);
+
+    fSignalEvent = nullptr;
+}
+
+///////////////////////////////////////////////
+/// \brief Process initialization. The estimators of every channel are reset.
+///
+void TRestDetectorSignalPedestalProcess::InitProcess() {
+    if (fTimeConstant < 1) {
+        RESTWarning << "TRestDetectorSignalPedestalProcess. The time constant must be at least 1 event"
+                    << RESTendl;
+        fTimeConstant = 1;
+    }
+
+    // The variance of a unit gaussian truncated at the point threshold
+    fTruncatedVariance = 1;
+    if (fPointThreshold > 0) {
+        const Double_t t = fPointThreshold;
+        fTruncatedVariance -= 2 * t * TMath::Gaus(t, 0, 1, true) / TMath::Erf(t / TMath::Sqrt2());
+    }
+
+    fPedestal.clear();
+    fVariance.clear();
+    fEntries.clear();
+}
+
+///////////////////////////////////////////////
+/// \brief It initializes the pedestal and noise of a channel from the median of
+/// the signal points and their median absolute deviation.
+///
+void TRestDetectorSignalPedestalProcess::InitChannel(Int_t id, const TRestDetectorSignal* signal) {
+    const Int_t nPoints = signal->GetNumberOfPoints();
+    fValues.resize(nPoints);
+    for (int i = 0; i < nPoints; i++) {
+        fValues[i] = signal->GetData(i);
+    }
+
+    auto middle = fValues.begin() + nPoints / 2;
+    nth_element(fValues.begin(), middle, fValues.end());
+    const Double_t median = *middle;
+
+    for (auto& value : fValues) {
+        value = abs(value - median);
+    }
+    nth_element(fValues.begin(), middle, fValues.end());
+
+    // The MAD of gaussian noise is 0.6745 sigma
+    Double_t variance = 1.4826 * 1.4826 * (*middle) * (*middle);
+
+    // If most points are identical, the deviation of all the points is used instead
+    if (variance == 0) {
+        for (const auto& value : fValues) {
+            variance += value * value;
+        }
+        variance /= nPoints;
+    }
+
+    fPedestal[id] = median;
+    fVariance[id] = variance;
+}
+
+///////////////////////////////////////////////
+/// \brief The main processing event function
+///
+TRestEvent* TRestDetectorSignalPedestalProcess::ProcessEvent(TRestEvent* inputEvent) {
+    fSignalEvent = (TRestDetectorSignalEvent*)inputEvent;
+
+    fPedestalMap.clear();
+    fNoiseMap.clear();
+    Double_t noiseSum = 0;
+
+    const Double_t weight = 1. / fTimeConstant;
+    for (int n = 0; n < fSignalEvent->GetNumberOfSignals(); n++) {
+        TRestDetectorSignal* signal = fSignalEvent->GetSignal(n);
+
+        const Int_t id = signal->GetID();
+        const Int_t nPoints = signal->GetNumberOfPoints();
+        if (id < 0 || nPoints == 0) {
+            continue;
+        }
+        if (id >= (Int_t)fEntries.size()) {
+            fPedestal.resize(id + 1, 0);
+            fVariance.resize(id + 1, 0);
+            fEntries.resize(id + 1, 0);
+        }
+        if (fEntries[id] == 0) {
+            InitChannel(id, signal);
+        }
+
+        // Single pass over the points compatible with the current pedestal
+        const Double_t pedestal = fPedestal[id];
+        const Double_t limit = fPointThreshold * std::sqrt(fVariance[id]);
+        Double_t sum = 0;
+        Double_t sum2 = 0;
+        Int_t count = 0;
+        for (int i = 0; i < nPoints; i++) {
+            const Double_t deviation = signal->GetData(i) - pedestal;
+            const Bool_t accepted = abs(deviation) <= limit;
+            sum += accepted * deviation;
+            sum2 += accepted * deviation * deviation;
+            count += accepted;
+        }
+
+        if (count > 0) {
+            // The first event replaces the median estimation completely
+            const Double_t eventWeight = fEntries[id] == 0 ? 1. : weight;
+            const Double_t mean = sum / count;
+            const Double_t variance = max(sum2 / count - mean * mean, 0.) / fTruncatedVariance;
+            fPedestal[id] += eventWeight * mean;
+            fVariance[id] += eventWeight * (variance - fVariance[id]);
+        }
+        fEntries[id]++;
+
+        if (fSubtractPedestal) {
+            signal->AddOffset(-fPedestal[id]);
+        }
+
+        const Double_t noise = std::sqrt(fVariance[id]);
+        fPedestalMap[id] = fPedestal[id];
+        fNoiseMap[id] = noise;
+        noiseSum += noise;
+    }
+
+    SetObservableValue("pedestal_map", fPedestalMap);
+    SetObservableValue("noise_map", fNoiseMap);
+    SetObservableValue("meanNoise", fNoiseMap.empty() ? 0. : noiseSum / fNoiseMap.size());
+
+    return fSignalEvent;
+}
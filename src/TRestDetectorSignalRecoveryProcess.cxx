@@ -145,6 +145,7 @@ void TRestDetectorSignalRecoveryProcess::Initialize() {
 
     fInputSignalEvent = nullptr;
     fOutputSignalEvent = new TRestDetectorSignalEvent();
+    fReadout = nullptr;
 }
 
 ///////////////////////////////////////////////
@@ -169,7 +170,9 @@ void TRestDetectorSignalRecoveryProcess::LoadConfig(const string& configFilename
 /// TRestDetectorReadout.
 ///
 void TRestDetectorSignalRecoveryProcess::InitProcess() {
-    fReadout = GetMetadata<TRestDetectorReadout>();
+    if (fReadout == nullptr) {
+        fReadout = GetMetadata<TRestDetectorReadout>();
+    }
 
     if (fReadout == nullptr) {
         RESTError << "TRestDetectorSignalRecoveryProcess. Readout has not been initialized!" << RESTendl;
@@ -177,14 +180,39 @@ void TRestDetectorSignalRecoveryProcess::InitProcess() {
     }
 }
 
+///////////////////////////////////////////////
+/// \brief It returns a working copy of the input signal with the given id, that
+/// is created the first time the signal is requested within the event. The
+/// charge removed from the neighbour channels is applied to this copy, so that
+/// the input signals are never modified.
+///
+TRestDetectorSignal* TRestDetectorSignalRecoveryProcess::GetNeighbourSignal(Int_t signalId) {
+    auto it = fNeighbourSignals.find(signalId);
+    if (it != fNeighbourSignals.end()) return &it->second;
+
+    const Int_t index = fInputSignalEvent->GetSignalIndex(signalId);
+    if (index < 0) return nullptr;
+
+    const TRestDetectorSignalEvent& input = *fInputSignalEvent;
+    return &fNeighbourSignals.emplace(signalId, *input.GetSignal(index)).first->second;
+}
+
 ///////////////////////////////////////////////
 /// \brief The main processing event function
 ///
+/// The input signals are copied at once to the output event, re-using the buffers
+/// of the signals of the previous output event, and the recovered channels replace
+/// the output signals with the same id. The input event is not modified.
+///
 TRestEvent* TRestDetectorSignalRecoveryProcess::ProcessEvent(TRestEvent* evInput) {
     fInputSignalEvent = (TRestDetectorSignalEvent*)evInput;
 
-    for (int n = 0; n < fInputSignalEvent->GetNumberOfSignals(); n++)
-        fOutputSignalEvent->AddSignal(*fInputSignalEvent->GetSignal(n));
+    fOutputSignalEvent->Initialize();
+    fOutputSignalEvent->SetEventInfo(fInputSignalEvent);
+    fOutputSignalEvent->CopySignals(*fInputSignalEvent);
+
+    fNeighbourSignals.clear();
+    fRecoveredSignals.clear();
 
     Int_t idL;
     Int_t idR;
@@ -194,8 +222,8 @@ TRestEvent* TRestDetectorSignalRecoveryProcess::ProcessEvent(TRestEvent* evInput
 
         if (idL == -1 || idR == -1) continue;
 
-        TRestDetectorSignal* leftSgnl = fInputSignalEvent->GetSignalById(idL);
-        TRestDetectorSignal* rightSgnl = fInputSignalEvent->GetSignalById(idR);
+        TRestDetectorSignal* leftSgnl = GetNeighbourSignal(idL);
+        TRestDetectorSignal* rightSgnl = GetNeighbourSignal(idR);
 
         /// If the dead channel has no charge on left and right then we do not
         /// correct. We could think about correction here? It means it is
@@ -250,11 +278,6 @@ TRestEvent* TRestDetectorSignalRecoveryProcess::ProcessEvent(TRestEvent* evInput
             continue;
         }
 
-        if (fOutputSignalEvent->GetSignalIndex(fChannelIds[x]) > 0)
-            fOutputSignalEvent->RemoveSignalWithId(fChannelIds[x]);
-
-        fOutputSignalEvent->AddSignal(recoveredSignal);
-
         /*cout << "Channel recovered!! " << endl;
         if( leftSgnl != nullptr && rightSgnl != nullptr )
             for( int n = 0; n < nPoints; n++ )
@@ -266,6 +289,16 @@ TRestEvent* TRestDetectorSignalRecoveryProcess::ProcessEvent(TRestEvent* evInput
             for (int n = 0; n < leftSgnl->GetNumberOfPoints(); n++)
                 RESTDebug << "Sample " << n << " : " << leftSgnl->GetData(n) << " + " << rightSgnl->GetData(n)
                           << " = " << recoveredSignal.GetData(n) << RESTendl;
+
+        fRecoveredSignals.push_back(std::move(recoveredSignal));
+    }
+
+    // The recovered channels are placed in the event once all the neighbours have been read
+    for (auto& recoveredSignal : fRecoveredSignals) {
+        if (fOutputSignalEvent->GetSignalIndex(recoveredSignal.GetID()) >= 0)
+            fOutputSignalEvent->RemoveSignalWithId(recoveredSignal.GetID());
+
+        fOutputSignalEvent->AddSignal(std::move(recoveredSignal));
     }
 
     RESTDebug << "Channels after : " << fOutputSignalEvent->GetNumberOfSignals() << RESTendl;
@@ -87,6 +87,12 @@
 /// z position and the energy.
 /// * **agetFit**: It performs a fit to each signal based on the aget response
 /// function to determine the z position and the energy.
+/// * **gaussFast**: Same as *gaussFit*, but the gaussian is obtained in closed
+/// form from the maximum point and its two neighbours. The ROOT fit is only
+/// used when the estimate fails, or its relative residual is above the
+/// **fastFitTolerance** parameter (0.1 by default).
+/// * **agetFast**: Same as *agetFit*, but using a fixed number of Gauss-Newton
+/// iterations on the signal points. It falls back to the ROOT fit as *gaussFast*.
 /// * **qCenter**: It will consider the shape of the signal to determine the
 /// the time used to transform to a Z-coordinate. The energy is also
 /// averaged on all points (Perhaps this is not the most appropiate?).
@@ -95,6 +101,19 @@
 /// * **intwindow**: Splits the time into a window defined by fIntwindow
 /// while performing the average of the data points. Every point corresponds
 /// to a Hit
+/// * **peaks**: One hit for each pulse of the signal, given by consecutive
+/// points over the **threshold** parameter. The hit energy is the integral of
+/// the pulse points over threshold, and the Z-coordinate is obtained from
+/// their charge weighted mean time. Pulses with less than **peakMinWidth**
+/// points (2 by default) are discarded, and pulses whose maxima are closer
+/// than **peakMinSeparation** (us) are merged. It keeps the information of
+/// multiple clusters in a channel with a small fraction of the hits produced
+/// by *all*. See TRestDetectorSignal::GetPulses.
+///
+/// The signals of each event are fitted independently by the fit based methods
+/// (*gaussFit*, *landauFit*, *agetFit*, *gaussFast* and *agetFast*), in parallel
+/// if the **fitThreads** parameter is larger than 1. See
+/// TRestDetectorSignalEvent::GetPeaks.
 ///
 /// \htmlonly <style>div.image img[src="signalToHits.png"]{width:800px;}</style> \endhtmlonly
 ///
@@ -125,6 +144,8 @@
 ///
 #include "TRestDetectorSignalToHitsProcess.h"
 
+#include <Math/MinimizerOptions.h>
+
 #include "TRestDetectorSetup.h"
 
 using namespace std;
@@ -221,266 +242,408 @@ void TRestDetectorSignalToHitsProcess::InitProcess() {
         }
     }
 
-    fReadout = GetMetadata<TRestDetectorReadout>();
+    if (fReadout == nullptr) fReadout = GetMetadata<TRestDetectorReadout>();
 
     if (fReadout == nullptr) {
         if (!this->GetError()) {
             this->SetError("The readout was not properly initialized.");
         }
     }
+
+    BuildChannelTable();
+
+    fMethodId = ResolveMethod(fMethod);
+    fPeakMethod = TRestDetectorSignalEvent::ResolvePeakMethod((string)fMethod);
+    if (fMethodId == Method::Unknown) {
+        SetError("The method " + (string)fMethod + " is not implemented!");
+    }
+
+    // the ROOT fits are done serially if the default minimizer is not thread safe
+    if (fFitThreads > 1 && fPeakMethod != TRestDetectorSignalEvent::PeakMethod::Unknown &&
+        !TRestDetectorSignalEvent::CanFitInThreads()) {
+        const Bool_t isFast = fPeakMethod == TRestDetectorSignalEvent::PeakMethod::GaussFast ||
+                              fPeakMethod == TRestDetectorSignalEvent::PeakMethod::AgetFast;
+        RESTWarning << "the default minimizer " << ROOT::Math::MinimizerOptions::DefaultMinimizerType()
+                    << " is not thread safe, "
+                    << (isFast ? "the signals falling back to a ROOT fit are fitted serially"
+                               : "the signals are fitted serially")
+                    << RESTendl;
+    }
 }
 
 ///////////////////////////////////////////////
-/// \brief The main processing event function
+/// \brief It returns the kernel corresponding to a signal to hits method name,
+/// or Method::Unknown if the method is not implemented.
 ///
-TRestEvent* TRestDetectorSignalToHitsProcess::ProcessEvent(TRestEvent* inputEvent) {
-    fSignalEvent = (TRestDetectorSignalEvent*)inputEvent;
-
-    if (!fReadout) {
-        return nullptr;
-    }
+TRestDetectorSignalToHitsProcess::Method TRestDetectorSignalToHitsProcess::ResolveMethod(
+    const TString& method) {
+    if (method == "onlyMax") return Method::OnlyMax;
+    if (method == "tripleMax") return Method::TripleMax;
+    if (method == "tripleMaxAverage") return Method::TripleMaxAverage;
+    if (method == "gaussFit" || method == "landauFit" || method == "agetFit" || method == "gaussFast" ||
+        method == "agetFast")
+        return Method::Fit;
+    if (method == "qCenter") return Method::QCenter;
+    if (method == "all") return Method::All;
+    if (method == "intwindow") return Method::IntWindow;
+    if (method == "peaks") return Method::Peaks;
+    return Method::Unknown;
+}
 
-    fHitsEvent->SetID(fSignalEvent->GetID());
-    fHitsEvent->SetSubID(fSignalEvent->GetSubID());
-    fHitsEvent->SetTimeStamp(fSignalEvent->GetTimeStamp());
-    fHitsEvent->SetSubEventTag(fSignalEvent->GetSubEventTag());
+///////////////////////////////////////////////
+/// \brief It fills the readout information of every daq channel into a table
+/// indexed by daq id, so that the readout is not scanned for each signal.
+///
+/// The plane, module and channel of each daq id are obtained with
+/// TRestDetectorReadout::GetPlaneModuleChannel. The coordinate that is not
+/// defined by the channel is placed at the module center, and the hit type is
+/// set accordingly.
+///
+void TRestDetectorSignalToHitsProcess::BuildChannelTable() {
+    fChannelInfo.clear();
+    if (fReadout == nullptr) return;
+
+    for (int p = 0; p < fReadout->GetNumberOfReadoutPlanes(); p++) {
+        TRestDetectorReadoutPlane* readoutPlane = fReadout->GetReadoutPlane(p);
+        for (size_t m = 0; m < readoutPlane->GetNumberOfModules(); m++) {
+            TRestDetectorReadoutModule* readoutModule = readoutPlane->GetModule(m);
+            for (size_t c = 0; c < readoutModule->GetNumberOfChannels(); c++) {
+                Int_t daqId = readoutModule->GetChannel(c)->GetDaqID();
+                if (daqId < 0) continue;
+                if (daqId >= (Int_t)fChannelInfo.size()) fChannelInfo.resize(daqId + 1);
+                if (fChannelInfo[daqId].valid) continue;
+
+                Int_t planeID, moduleID, readoutChannel = -1;
+                fReadout->GetPlaneModuleChannel(daqId, planeID, moduleID, readoutChannel);
+                if (readoutChannel == -1) continue;
+
+                TRestDetectorReadoutPlane* plane = fReadout->GetReadoutPlaneWithID(planeID);
+                TRestDetectorReadoutModule* mod = plane->GetModuleByID(moduleID);
+
+                ChannelInfo& info = fChannelInfo[daqId];
+
+                // For the moment this will only be valid for a TPC with its axis (field
+                // direction) being in z
+                info.fieldZDirection = plane->GetNormal().Z();
+                info.zPosition = plane->GetPosition().Z();
+
+                info.x = plane->GetX(moduleID, readoutChannel);
+                info.y = plane->GetY(moduleID, readoutChannel);
+
+                const TVector2 moduleCenter(mod->GetSize().X() / 2, mod->GetSize().Y() / 2);
+                info.type = XYZ;
+                if (TMath::IsNaN(info.x)) {
+                    info.x = mod->GetPlaneCoordinates(moduleCenter).X();
+                    info.type = YZ;
+                } else if (TMath::IsNaN(info.y)) {
+                    info.y = mod->GetPlaneCoordinates(moduleCenter).Y();
+                    info.type = XZ;
+                }
 
-    RESTDebug << "TRestDetectorSignalToHitsProcess. Event id : " << fHitsEvent->GetID() << RESTendl;
-    if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Extreme) {
-        fSignalEvent->PrintEvent();
+                info.valid = true;
+            }
+        }
     }
+}
 
-    Int_t numberOfSignals = fSignalEvent->GetNumberOfSignals();
-
-    if (numberOfSignals == 0) return nullptr;
+///////////////////////////////////////////////
+/// \brief The onlyMax kernel. One hit per signal at its maximum.
+///
+void TRestDetectorSignalToHitsProcess::AddOnlyMaxHits() {
+    const bool debug = GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug;
 
-    Int_t planeID, readoutChannel = -1, readoutModule;
-    for (int i = 0; i < numberOfSignals; i++) {
+    for (int i = 0; i < fSignalEvent->GetNumberOfSignals(); i++) {
         TRestDetectorSignal* signal = fSignalEvent->GetSignal(i);
-        Int_t signalID = signal->GetSignalID();
+        const ChannelInfo* info = GetChannelInfo(signal->GetSignalID());
+        if (info == nullptr) continue;
 
-        if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug)
-            cout << "Searching readout coordinates for signal ID : " << signalID << endl;
+        Int_t bin = signal->GetMaxIndex();
+        Double_t hitTime = signal->GetTime(bin);
+        Double_t energy = signal->GetData(bin);
+        Double_t z = GetHitZ(*info, hitTime);
 
-        fReadout->GetPlaneModuleChannel(signalID, planeID, readoutModule, readoutChannel);
+        if (debug)
+            cout << "Adding hit. Time : " << hitTime << " x : " << info->x << " y : " << info->y
+                 << " z : " << z << " Energy : " << energy << endl;
 
-        if (readoutChannel == -1) {
-            // cout << "REST Warning : Readout channel not found for daq ID : " << signalID << endl;
-            continue;
-        }
-        /////////////////////////////////////////////////////////////////////////
-
-        TRestDetectorReadoutPlane* plane = fReadout->GetReadoutPlaneWithID(planeID);
-
-        // For the moment this will only be valid for a TPC with its axis (field
-        // direction) being in z
-        Double_t fieldZDirection = plane->GetNormal().Z();
-        Double_t zPosition = plane->GetPosition().Z();
-
-        Double_t x = plane->GetX(readoutModule, readoutChannel);
-        Double_t y = plane->GetY(readoutModule, readoutChannel);
-
-        REST_HitType type = XYZ;
-        TRestDetectorReadoutModule* mod = plane->GetModuleByID(readoutModule);
-        if (TMath::IsNaN(x)) {
-            x = mod->GetPlaneCoordinates(TVector2(mod->GetSize().X() / 2, mod->GetSize().Y() / 2)).X();
-            type = YZ;
-        } else if (TMath::IsNaN(y)) {
-            y = mod->GetPlaneCoordinates(TVector2(mod->GetSize().X() / 2, mod->GetSize().Y() / 2)).Y();
-            type = XZ;
-        }
+        fHitsEvent->AddHit(info->x, info->y, z, energy, 0, info->type);
+    }
+}
 
-        if (fMethod == "onlyMax") {
-            Double_t hitTime = signal->GetMaxPeakTime();
-            Double_t distanceToPlane = hitTime * fDriftVelocity;
+///////////////////////////////////////////////
+/// \brief The tripleMax kernel. Three hits per signal, at the maximum and its
+/// two neighbour points.
+///
+void TRestDetectorSignalToHitsProcess::AddTripleMaxHits() {
+    for (int i = 0; i < fSignalEvent->GetNumberOfSignals(); i++) {
+        TRestDetectorSignal* signal = fSignalEvent->GetSignal(i);
+        const ChannelInfo* info = GetChannelInfo(signal->GetSignalID());
+        if (info == nullptr) continue;
 
-            if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug)
-                cout << "Distance to plane : " << distanceToPlane << endl;
+        Int_t bin = signal->GetMaxIndex();
+        int binprev = (bin - 1) < 0 ? bin : bin - 1;
+        int binnext = (bin + 1) > signal->GetNumberOfPoints() - 1 ? bin : bin + 1;
 
-            Double_t z = zPosition + fieldZDirection * distanceToPlane;
+        for (int b : {bin, binprev, binnext}) {
+            fHitsEvent->AddHit(info->x, info->y, GetHitZ(*info, signal->GetTime(b)), signal->GetData(b), 0,
+                               info->type);
+        }
+    }
+}
 
-            Double_t energy = signal->GetMaxPeakValue();
+///////////////////////////////////////////////
+/// \brief The tripleMaxAverage kernel. One hit per signal, at the charge
+/// weighted position of the maximum and its two neighbour points.
+///
+void TRestDetectorSignalToHitsProcess::AddTripleMaxAverageHits() {
+    const bool debug = GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug;
 
-            if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug)
-                cout << "Adding hit. Time : " << hitTime << " x : " << x << " y : " << y << " z : " << z
-                     << " Energy : " << energy << endl;
+    for (int i = 0; i < fSignalEvent->GetNumberOfSignals(); i++) {
+        TRestDetectorSignal* signal = fSignalEvent->GetSignal(i);
+        const ChannelInfo* info = GetChannelInfo(signal->GetSignalID());
+        if (info == nullptr) continue;
 
-            fHitsEvent->AddHit(x, y, z, energy, 0, type);
-        } else if (fMethod == "tripleMax") {
-            Int_t bin = signal->GetMaxIndex();
-            int binprev = (bin - 1) < 0 ? bin : bin - 1;
-            int binnext = (bin + 1) > signal->GetNumberOfPoints() - 1 ? bin : bin + 1;
+        Int_t bin = signal->GetMaxIndex();
+        int binprev = (bin - 1) < 0 ? bin : bin - 1;
+        int binnext = (bin + 1) > signal->GetNumberOfPoints() - 1 ? bin : bin + 1;
 
-            Double_t hitTime = signal->GetTime(bin);
-            Double_t energy = signal->GetData(bin);
+        Double_t energy1 = signal->GetData(bin);
+        Double_t z1 = GetHitZ(*info, signal->GetTime(bin));
 
-            Double_t distanceToPlane = hitTime * fDriftVelocity;
-            Double_t z = zPosition + fieldZDirection * distanceToPlane;
+        Double_t energy2 = signal->GetData(binprev);
+        Double_t z2 = GetHitZ(*info, signal->GetTime(binprev));
 
-            fHitsEvent->AddHit(x, y, z, energy, 0, type);
+        Double_t energy3 = signal->GetData(binnext);
+        Double_t z3 = GetHitZ(*info, signal->GetTime(binnext));
 
-            hitTime = signal->GetTime(binprev);
-            energy = signal->GetData(binprev);
+        Double_t eTot = energy1 + energy2 + energy3;
 
-            distanceToPlane = hitTime * fDriftVelocity;
-            z = zPosition + fieldZDirection * distanceToPlane;
+        Double_t zAvg = ((z1 * energy1) + (z2 * energy2) + (z3 * energy3)) / eTot;
+        Double_t eAvg = eTot / 3.0;
 
-            fHitsEvent->AddHit(x, y, z, energy, 0, type);
+        fHitsEvent->AddHit(info->x, info->y, zAvg, eAvg, 0, info->type);
 
-            hitTime = signal->GetTime(binnext);
-            energy = signal->GetData(binnext);
+        if (debug) {
+            cout << "Adding hit. x : " << info->x << " y : " << info->y << " z : " << zAvg
+                 << " Energy : " << eAvg << endl;
+            cout << "z1, z2, z3 = " << z1 << ", " << z2 << ", " << z3 << endl;
+            cout << "E1, E2, E3 = " << energy1 << ", " << energy2 << ", " << energy3 << endl;
+        }
+    }
+}
 
-            distanceToPlane = hitTime * fDriftVelocity;
-            z = zPosition + fieldZDirection * distanceToPlane;
+///////////////////////////////////////////////
+/// \brief The kernel of the fit based methods. One hit per signal at the peak
+/// found by TRestDetectorSignalEvent::GetPeaks.
+///
+void TRestDetectorSignalToHitsProcess::AddFitHits() {
+    // Only the signals with a readout position are fitted, all of them at once
+    fFitSignals.clear();
+    for (int i = 0; i < fSignalEvent->GetNumberOfSignals(); i++) {
+        if (GetChannelInfo(fSignalEvent->GetSignal(i)->GetSignalID()) != nullptr) {
+            fFitSignals.push_back(i);
+        }
+    }
+    const auto peaks = fSignalEvent->GetPeaks(fPeakMethod, fFitThreads, fFastFitTolerance, &fFitSignals);
 
-            fHitsEvent->AddHit(x, y, z, energy, 0, type);
+    for (const auto i : fFitSignals) {
+        TRestDetectorSignal* signal = fSignalEvent->GetSignal(i);
+        const ChannelInfo* info = GetChannelInfo(signal->GetSignalID());
 
-            if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug) {
-                cout << "Distance to plane : " << distanceToPlane << endl;
-                cout << "Adding hit. Time : " << hitTime << " x : " << x << " y : " << y << " z : " << z
-                     << " Energy : " << energy << endl;
+        const auto& peak = peaks[i];
+        if (!peak) {
+            if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Info) {
+                cout << "Unable to find peak for signal " << signal->GetSignalID()
+                     << " with method: " << fMethod << endl;
             }
-        } else if (fMethod == "tripleMaxAverage") {
-            Int_t bin = signal->GetMaxIndex();
-            int binprev = (bin - 1) < 0 ? bin : bin - 1;
-            int binnext = (bin + 1) > signal->GetNumberOfPoints() - 1 ? bin : bin + 1;
+            continue;
+        }
+        const auto [time, energy] = peak.value();
+
+        const auto z = GetHitZ(*info, time);
+
+        if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug) {
+            cout << "Signal event : " << signal->GetSignalID()
+                 << "--------------------------------------------------------" << endl;
+            cout << "Method: " << fMethod << " : time " << time << " us and energy : " << energy << endl;
+            cout << "Signal to hit info : zPosition : " << info->zPosition
+                 << "; fieldZDirection : " << info->fieldZDirection << " and driftV : " << fDriftVelocity
+                 << endl;
+            cout << "Adding hit. Time : " << time << " us x : " << info->x << " y : " << info->y
+                 << " z : " << z << " Energy : " << energy << endl;
+        }
 
-            Double_t hitTime = signal->GetTime(bin);
-            Double_t energy1 = signal->GetData(bin);
+        fHitsEvent->AddHit(info->x, info->y, z, energy, 0, info->type);
+    }
+}
 
-            Double_t distanceToPlane = hitTime * fDriftVelocity;
-            Double_t z1 = zPosition + fieldZDirection * distanceToPlane;
+///////////////////////////////////////////////
+/// \brief The qCenter kernel. One hit per signal at its charge weighted time,
+/// with the average charge of the signal points.
+///
+void TRestDetectorSignalToHitsProcess::AddQCenterHits() {
+    for (int i = 0; i < fSignalEvent->GetNumberOfSignals(); i++) {
+        TRestDetectorSignal* signal = fSignalEvent->GetSignal(i);
+        const ChannelInfo* info = GetChannelInfo(signal->GetSignalID());
+        if (info == nullptr) continue;
+
+        const Int_t nPoints = signal->GetNumberOfPoints();
+        Double_t energy_signal = 0;
+        Double_t distanceToPlane = 0;
+        for (int j = 0; j < nPoints; j++) {
+            Double_t energy_point = signal->GetData(j);
+            energy_signal += energy_point;
+            distanceToPlane += signal->GetTime(j) * fDriftVelocity * energy_point;
+        }
+        Double_t energy = energy_signal / nPoints;
 
-            hitTime = signal->GetTime(binprev);
-            Double_t energy2 = signal->GetData(binprev);
+        Double_t z = info->zPosition + info->fieldZDirection * (distanceToPlane / energy_signal);
+        fHitsEvent->AddHit(info->x, info->y, z, energy, 0, info->type);
+    }
+}
 
-            distanceToPlane = hitTime * fDriftVelocity;
-            Double_t z2 = zPosition + fieldZDirection * distanceToPlane;
+///////////////////////////////////////////////
+/// \brief The all kernel. One hit for each point of every signal.
+///
+void TRestDetectorSignalToHitsProcess::AddAllHits() {
+    const bool debug = GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug;
 
-            hitTime = signal->GetTime(binnext);
-            Double_t energy3 = signal->GetData(binnext);
+    for (int i = 0; i < fSignalEvent->GetNumberOfSignals(); i++) {
+        TRestDetectorSignal* signal = fSignalEvent->GetSignal(i);
+        const ChannelInfo* info = GetChannelInfo(signal->GetSignalID());
+        if (info == nullptr) continue;
 
-            distanceToPlane = hitTime * fDriftVelocity;
-            Double_t z3 = zPosition + fieldZDirection * distanceToPlane;
+        const Int_t nPoints = signal->GetNumberOfPoints();
+        for (int j = 0; j < nPoints; j++) {
+            Double_t z = GetHitZ(*info, signal->GetTime(j));
 
-            Double_t eTot = energy1 + energy2 + energy3;
+            if (debug)
+                cout << "Adding hit. Time : " << signal->GetTime(j) << " x : " << info->x
+                     << " y : " << info->y << " z : " << z << endl;
 
-            Double_t zAvg = ((z1 * energy1) + (z2 * energy2) + (z3 * energy3)) / eTot;
-            Double_t eAvg = eTot / 3.0;
+            fHitsEvent->AddHit(info->x, info->y, z, signal->GetData(j), 0, info->type);
+        }
+    }
+}
 
-            fHitsEvent->AddHit(x, y, zAvg, eAvg, 0, type);
+///////////////////////////////////////////////
+/// \brief The intwindow kernel. One hit for each fIntWindow time window of
+/// every signal, with the average charge of the window points, if it is above
+/// fThreshold. See TRestDetectorSignal::GetWindowAverages.
+///
+void TRestDetectorSignalToHitsProcess::AddIntWindowHits() {
+    for (int i = 0; i < fSignalEvent->GetNumberOfSignals(); i++) {
+        TRestDetectorSignal* signal = fSignalEvent->GetSignal(i);
+        const ChannelInfo* info = GetChannelInfo(signal->GetSignalID());
+        if (info == nullptr) continue;
 
-            if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug) {
-                cout << "Distance to plane: " << distanceToPlane << endl;
-                cout << "Adding hit. Time : " << hitTime << " x : " << x << " y : " << y << " z : " << zAvg
-                     << " Energy : " << eAvg << endl;
-                cout << "z1, z2, z3 = " << z1 << ", " << z2 << ", " << z3 << endl;
-                cout << "E1, E2, E3 = " << energy1 << ", " << energy2 << ", " << energy3 << endl;
-            }
+        signal->GetWindowAverages(fIntWindow, fWindowAverages);
 
-        } else if (fMethod == "gaussFit" || fMethod == "landauFit" || fMethod == "agetFit") {
-            optional<pair<Double_t, Double_t>> peak;
-            if (fMethod == "gaussFit") {
-                peak = signal->GetPeakGauss();
-            } else if (fMethod == "landauFit") {
-                peak = signal->GetPeakLandau();
-            } else if (fMethod == "agetFit") {
-                peak = signal->GetPeakAget();
-            } else {
-                throw std::runtime_error("Invalid method");
-            }
-            if (!peak) {
-                if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Info) {
-                    cout << "Unable to find peak for signal " << signal->GetSignalID()
-                         << " with method: " << fMethod << endl;
-                }
+        for (const auto& [index, energy] : fWindowAverages) {
+            Double_t hitTime = index * fIntWindow + fIntWindow / 2.;
+            if (energy < fThreshold) {
                 continue;
             }
-            const auto [time, energy] = peak.value();
-
-            const auto distanceToPlane = time * fDriftVelocity;
-            const auto z = zPosition + fieldZDirection * distanceToPlane;
-
-            if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug) {
-                cout << "Signal event : " << signal->GetSignalID()
-                     << "--------------------------------------------------------" << endl;
-                cout << "Method: " << fMethod << " : time " << time << " us and energy : " << energy << endl;
-                cout << "Signal to hit info : zPosition : " << zPosition
-                     << "; fieldZDirection : " << fieldZDirection << " and driftV : " << fDriftVelocity
-                     << endl;
-                cout << "Adding hit. Time : " << time << " us x : " << x << " y : " << y << " z : " << z
-                     << " Energy : " << energy << endl;
-            }
+            RESTDebug << "TimeBin " << index << " Time " << hitTime << " Charge: " << energy
+                      << " Thr: " << (fThreshold) << RESTendl;
+            Double_t z = GetHitZ(*info, hitTime);
 
-            fHitsEvent->AddHit(x, y, z, energy, 0, type);
-        } else if (fMethod == "qCenter") {
-            Double_t energy_signal = 0;
-            Double_t distanceToPlane = 0;
+            RESTDebug << "Adding hit. Time : " << hitTime << " x : " << info->x << " y : " << info->y
+                      << " z : " << z << " type " << info->type << RESTendl;
 
-            for (int j = 0; j < signal->GetNumberOfPoints(); j++) {
-                Double_t energy_point = signal->GetData(j);
-                energy_signal += energy_point;
-                distanceToPlane += signal->GetTime(j) * fDriftVelocity * energy_point;
-            }
-            Double_t energy = energy_signal / signal->GetNumberOfPoints();
+            fHitsEvent->AddHit(info->x, info->y, z, energy, 0, info->type);
+        }
+    }
+}
 
-            Double_t z = zPosition + fieldZDirection * (distanceToPlane / energy_signal);
-            fHitsEvent->AddHit(x, y, z, energy, 0, type);
-        } else if (fMethod == "all") {
-            for (int j = 0; j < signal->GetNumberOfPoints(); j++) {
-                Double_t energy = signal->GetData(j);
+///////////////////////////////////////////////
+/// \brief The peaks kernel. One hit for each pulse over fThreshold of every
+/// signal, with the pulse integral as energy. See TRestDetectorSignal::GetPulses.
+///
+void TRestDetectorSignalToHitsProcess::AddPeakHits() {
+    for (int i = 0; i < fSignalEvent->GetNumberOfSignals(); i++) {
+        TRestDetectorSignal* signal = fSignalEvent->GetSignal(i);
+        const ChannelInfo* info = GetChannelInfo(signal->GetSignalID());
+        if (info == nullptr) continue;
 
-                Double_t distanceToPlane = signal->GetTime(j) * fDriftVelocity;
+        signal->GetPulses(fThreshold, fPulses, fPeakMinWidth, fPeakMinSeparation);
 
-                if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug) {
-                    cout << "Time : " << signal->GetTime(j) << " Drift velocity : " << fDriftVelocity << endl;
-                    cout << "Distance to plane : " << distanceToPlane << endl;
-                }
+        for (const auto& pulse : fPulses) {
+            Double_t z = GetHitZ(*info, pulse.time);
+
+            RESTDebug << "Adding hit. Time : " << pulse.time << " x : " << info->x << " y : " << info->y
+                      << " z : " << z << " energy : " << pulse.integral << RESTendl;
+
+            fHitsEvent->AddHit(info->x, info->y, z, pulse.integral, 0, info->type);
+        }
+    }
+}
 
-                Double_t z = zPosition + fieldZDirection * distanceToPlane;
+///////////////////////////////////////////////
+/// \brief The main processing event function
+///
+TRestEvent* TRestDetectorSignalToHitsProcess::ProcessEvent(TRestEvent* inputEvent) {
+    fSignalEvent = (TRestDetectorSignalEvent*)inputEvent;
 
-                if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Debug)
-                    cout << "Adding hit. Time : " << signal->GetTime(j) << " x : " << x << " y : " << y
-                         << " z : " << z << endl;
+    if (!fReadout) {
+        return nullptr;
+    }
 
-                fHitsEvent->AddHit(x, y, z, energy, 0, type);
-            }
-        } else if (fMethod == "intwindow") {
-            Int_t nPoints = signal->GetNumberOfPoints();
-            std::map<int, std::pair<int, double>> windowMap;
-            for (int j = 0; j < nPoints; j++) {
-                int index = signal->GetTime(j) / fIntWindow;
-                auto it = windowMap.find(index);
-                if (it != windowMap.end()) {
-                    it->second.first++;
-                    it->second.second += signal->GetData(j);
-                } else {
-                    windowMap[index] = std::make_pair(1, signal->GetData(j));
-                }
-            }
+    fHitsEvent->SetID(fSignalEvent->GetID());
+    fHitsEvent->SetSubID(fSignalEvent->GetSubID());
+    fHitsEvent->SetTimeStamp(fSignalEvent->GetTimeStamp());
+    fHitsEvent->SetSubEventTag(fSignalEvent->GetSubEventTag());
 
-            for (const auto& [index, pair] : windowMap) {
-                Double_t hitTime = index * fIntWindow + fIntWindow / 2.;
-                Double_t energy = pair.second / pair.first;
-                if (energy < fThreshold) {
-                    continue;
-                }
-                RESTDebug << "TimeBin " << index << " Time " << hitTime << " Charge: " << energy
-                          << " Thr: " << (fThreshold) << RESTendl;
-                Double_t distanceToPlane = hitTime * fDriftVelocity;
-                Double_t z = zPosition + fieldZDirection * distanceToPlane;
+    RESTDebug << "TRestDetectorSignalToHitsProcess. Event id : " << fHitsEvent->GetID() << RESTendl;
+    if (GetVerboseLevel() >= TRestStringOutput::REST_Verbose_Level::REST_Extreme) {
+        fSignalEvent->PrintEvent();
+    }
 
-                RESTDebug << "Time : " << hitTime << " Drift velocity : " << fDriftVelocity
-                          << "\nDistance to plane : " << distanceToPlane << RESTendl;
-                RESTDebug << "Adding hit. Time : " << hitTime << " x : " << x << " y : " << y << " z : " << z
-                          << " type " << type << RESTendl;
+    Int_t numberOfSignals = fSignalEvent->GetNumberOfSignals();
 
-                fHitsEvent->AddHit(x, y, z, energy, 0, type);
-            }
-        } else {
+    if (numberOfSignals == 0) return nullptr;
+
+    // The hits storage is reserved for the number of hits expected from the method
+    size_t expectedHits = numberOfSignals;
+    if (fMethodId == Method::TripleMax) {
+        expectedHits = 3 * numberOfSignals;
+    } else if (fMethodId == Method::All) {
+        expectedHits = 0;
+        for (int i = 0; i < numberOfSignals; i++) {
+            expectedHits += fSignalEvent->GetSignal(i)->GetNumberOfPoints();
+        }
+    }
+    fHitsEvent->Reserve(fHitsEvent->GetNumberOfHits() + expectedHits);
+
+    // The signals are converted by the kernel of the method resolved at InitProcess
+    switch (fMethodId) {
+        case Method::OnlyMax:
+            AddOnlyMaxHits();
+            break;
+        case Method::TripleMax:
+            AddTripleMaxHits();
+            break;
+        case Method::TripleMaxAverage:
+            AddTripleMaxAverageHits();
+            break;
+        case Method::Fit:
+            AddFitHits();
+            break;
+        case Method::QCenter:
+            AddQCenterHits();
+            break;
+        case Method::All:
+            AddAllHits();
+            break;
+        case Method::IntWindow:
+            AddIntWindowHits();
+            break;
+        case Method::Peaks:
+            AddPeakHits();
+            break;
+        default:
             string errMsg = "The method " + (string)fMethod + " is not implemented!";
             SetError(errMsg);
-        }
     }
 
     RESTDebug << "TRestDetectorSignalToHitsProcess. Hits added : " << fHitsEvent->GetNumberOfHits()
@@ -0,0 +1,187 @@
+/*************************************************************************
+ * This file is part of the REST software framework.                     *
+ *                                                                       *
+ * Copyright (C) 2016 GIFNA/TREX (University of Zaragoza)                *
+ * For more information see http://gifna.unizar.es/trex                  *
+ *                                                                       *
+ * REST is free software: you can redistribute it and/or modify          *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation, either version 3 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * REST is distributed in the hope that it will be useful,               *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have a copy of the GNU General Public License along with   *
+ * REST in $REST_PATH/LICENSE.                                           *
+ * If not, see http://www.gnu.org/licenses/.                             *
+ * For the list of contributors see $REST_PATH/CREDITS.                  *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+/// This process removes the points of each TRestDetectorSignal that are
+/// not found in a region of interest, reducing the size of the event and the
+/// time spent by the processes that come after it.
+///
+/// The baseline and its fluctuation are calculated for each signal using the
+/// points inside the range given by the parameter "baseLineRange". A point is
+/// over threshold if it is "pointThreshold" baseline sigmas over the baseline.
+/// A region of interest contains each point over threshold, together with the
+/// "preSamples" points before it and the "postSamples" points after it.
+/// Overlapping or adjacent regions are merged.
+///
+/// The points of each signal are not modified, the remaining points keep
+/// their time and charge. For uniformly sampled signals the remaining points
+/// are stored as segments of consecutive samples, see
+/// TRestDetectorSignal::KeepRegions, so that the time values do not need to
+/// be stored. Signals without any point over threshold are removed from the
+/// event, and the event is discarded if no signal remains.
+///
+/// The baseline range is given in samples, and it is only meaningful for
+/// uniformly sampled signals without gaps. Any other signal, as the sparse
+/// signals produced by the simulation or a signal that was already suppressed,
+/// is taken to have a zero baseline without fluctuation, and every point with a
+/// positive charge is over threshold.
+///
+/// Since the baseline points are usually removed, processes calculating the
+/// baseline from a range of points should be placed before this process.
+///
+/// The following observable is defined:
+/// * **compression**: The number of points of the input event divided by the
+/// number of points kept.
+///
+/// An example of the process definition:
+/// \code
+/// <addProcess type="TRestDetectorSignalZeroSuppressionProcess" name="zS" value="ON">
+///     <parameter name="baseLineRange" value="(5,55)" />
+///     <parameter name="pointThreshold" value="3" />
+///     <parameter name="preSamples" value="5" />
+///     <parameter name="postSamples" value="10" />
+/// </addProcess>
+/// \endcode
+///
+///--------------------------------------------------------------------------
+///
+/// RESTsoft - Software for Rare Event Searches with TPCs
+///
+/// History of developments:
+///
+/// 2026-October First implementation of TRestDetectorSignalZeroSuppressionProcess.
+///
+/// \class      TRestDetectorSignalZeroSuppressionProcess
+///
+/// <hr>
+///
+
+#include "TRestDetectorSignalZeroSuppressionProcess.h"
+
+using namespace std;
+
+ClassImp(TRestDetectorSignalZeroSuppressionProcess);
+
+///////////////////////////////////////////////
+/// \brief Default constructor
+///
+TRestDetectorSignalZeroSuppressionProcess::TRestDetectorSignalZeroSuppressionProcess() { Initialize(); }
+
+///////////////////////////////////////////////
+/// \brief Constructor loading data from a config file
+///
+/// \param configFilename A const char* giving the path to an RML file.
+///
+TRestDetectorSignalZeroSuppressionProcess::TRestDetectorSignalZeroSuppressionProcess(
+    const char* configFilename) {
+    Initialize();
+
+    if (LoadConfigFromFile(configFilename) == -1) {
+        LoadDefaultConfig();
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief Default destructor. The output event is the input event, and it is
+/// not owned by this process.
+///
+TRestDetectorSignalZeroSuppressionProcess::~TRestDetectorSignalZeroSuppressionProcess() {}
+
+///////////////////////////////////////////////
+/// \brief Function to load the default config in absence of RML input
+///
+void TRestDetectorSignalZeroSuppressionProcess::LoadDefaultConfig() {
+    SetName("signalZeroSuppressionProcess-Default");
+    SetTitle("Default config");
+
+    fBaseLineRange = TVector2(5, 55);
+    fPointThreshold = 3.;
+    fPreSamples = 5;
+    fPostSamples = 10;
+}
+
+///////////////////////////////////////////////
+/// \brief Function to initialize input/output event members and define the
+/// section name
+///
+void TRestDetectorSignalZeroSuppressionProcess::Initialize() {
+    SetSectionName(this->ClassName());
+    SetLibraryVersion(LIBRARY_VERSION);
+
+    fSignalEvent = nullptr;
+}
+
+///////////////////////////////////////////////
+/// \brief The main processing event function
+///
+TRestEvent* TRestDetectorSignalZeroSuppressionProcess::ProcessEvent(TRestEvent* inputEvent) {
+    fSignalEvent = (TRestDetectorSignalEvent*)inputEvent;
+
+    Long64_t inputPoints = 0;
+    Long64_t outputPoints = 0;
+    for (int n = 0; n < fSignalEvent->GetNumberOfSignals(); n++) {
+        TRestDetectorSignal* signal = fSignalEvent->GetSignal(n);
+        signal->SetImplicitTimeAxis();
+
+        // The baseline range is given in samples, so that it is only used for signals made of
+        // consecutive samples. Sparse signals have a zero baseline.
+        const Int_t nPoints = signal->GetNumberOfPoints();
+        Double_t threshold = 0;
+        if (signal->HasImplicitTimeAxis() && signal->GetNumberOfSegments() == 1) {
+            const auto statistics =
+                signal->ComputeStatistics((Int_t)fBaseLineRange.X(), (Int_t)fBaseLineRange.Y());
+            threshold = statistics.baseLine + fPointThreshold * statistics.baseLineSigma;
+        }
+
+        fRegions.clear();
+        for (int i = 0; i < nPoints; i++) {
+            if (signal->GetData(i) <= threshold) {
+                continue;
+            }
+            const Int_t first = max(i - fPreSamples, 0);
+            const Int_t last = min(i + fPostSamples, nPoints - 1);
+            if (!fRegions.empty() && first <= fRegions.back().second + 1) {
+                fRegions.back().second = last;
+            } else {
+                fRegions.emplace_back(first, last);
+            }
+        }
+
+        signal->KeepRegions(fRegions);
+
+        inputPoints += nPoints;
+        outputPoints += signal->GetNumberOfPoints();
+    }
+
+    const Int_t removed = fSignalEvent->RemoveEmptySignals();
+
+    SetObservableValue("compression", outputPoints > 0 ? (Double_t)inputPoints / outputPoints : 0.);
+
+    RESTDebug << "TRestDetectorSignalZeroSuppressionProcess. Points kept : " << outputPoints << " of "
+              << inputPoints << ". Signals removed : " << removed << RESTendl;
+
+    if (fSignalEvent->GetNumberOfSignals() == 0) {
+        return nullptr;
+    }
+
+    return fSignalEvent;
+}
@@ -16,20 +16,35 @@
 
 #include "TRestDetectorSingleChannelAnalysisProcess.h"
 
+#include <Math/MinimizerOptions.h>
+#include <TF1.h>
+#include <TFile.h>
 #include <TFitResult.h>
+#include <TKey.h>
 #include <TLatex.h>
 #include <TLegend.h>
 #include <TLine.h>
 #include <TPaveText.h>
+#include <TROOT.h>
 #include <TRandom.h>
 #include <TSpectrum.h>
 
+#include <atomic>
+#include <cmath>
+#include <thread>
+
 using namespace std;
 
 ClassImp(TRestDetectorSingleChannelAnalysisProcess);
 
 TRestDetectorSingleChannelAnalysisProcess::TRestDetectorSingleChannelAnalysisProcess() { Initialize(); }
 
+TRestDetectorSingleChannelAnalysisProcess::TRestDetectorSingleChannelAnalysisProcess(
+    const char* configFilename) {
+    Initialize();
+    LoadConfigFromFile(configFilename);
+}
+
 TRestDetectorSingleChannelAnalysisProcess::~TRestDetectorSingleChannelAnalysisProcess() {}
 
 void TRestDetectorSingleChannelAnalysisProcess::Initialize() {
@@ -39,11 +54,17 @@ void TRestDetectorSingleChannelAnalysisProcess::Initialize() {
     fSignalEvent = nullptr;
 
     fReadout = nullptr;
+    fCalib = nullptr;
 }
 
 void TRestDetectorSingleChannelAnalysisProcess::InitProcess() {
     fReadout = GetMetadata<TRestDetectorReadout>();
     fCalib = GetMetadata<TRestDetectorGainMap>();
+
+    fChannelSpectra.clear();
+    fChannelEntries.clear();
+    fChannelGainTable.clear();
+
     if (fReadout == nullptr) {
     } else {
         for (int i = 0; i < fReadout->GetNumberOfReadoutPlanes(); i++) {
@@ -54,9 +75,7 @@ void TRestDetectorSingleChannelAnalysisProcess::InitProcess() {
                     auto channel = mod->GetChannel(k);
                     fChannelGain[channel->GetDaqID()] = 1;       // default correction factor is 1
                     fChannelGainError[channel->GetDaqID()] = 1;  // relative error
-                    fChannelThrIntegral[channel->GetDaqID()] =
-                        new TH1D(Form("h%i", channel->GetDaqID()), Form("h%i", channel->GetDaqID()), 100, 0,
-                                 fSpecFitRange.Y() * 1.5);
+                    FillChannelSpectrum(channel->GetDaqID(), 0, false);
                 }
             }
         }
@@ -72,6 +91,9 @@ void TRestDetectorSingleChannelAnalysisProcess::InitProcess() {
                 }
             }
 
+            // the gains are copied into a table indexed by daq id for the event loop
+            fCalib->FillChannelGainTable(fChannelGainTable, std::numeric_limits<Double_t>::quiet_NaN());
+
         } else {
             RESTError << "You must set a TRestDetectorGainMap metadata object to apply gain correction!"
                       << RESTendl;
@@ -94,41 +116,49 @@ TRestEvent* TRestDetectorSingleChannelAnalysisProcess::ProcessEvent(TRestEvent*
     Double_t new_PeakAmplitudeIntegral = 0;
     Double_t new_ThresholdIntegral = 0;
 
-    map<int, Double_t> sAna_max_amplitude_map = GetObservableValue<map<int, Double_t>>("max_amplitude_map");
-    map<int, Double_t> sAna_thr_integral_map = GetObservableValue<map<int, Double_t>>("thr_integral_map");
-    Double_t sAna_ThresholdIntegral = GetObservableValue<Double_t>("ThresholdIntegral");
-    Double_t sAna_NumberOfGoodSignals = GetObservableValue<int>("NumberOfGoodSignals");
-
     if (fCreateGainMap) {
+        Double_t sAna_ThresholdIntegral = GetObservableValue<Double_t>("ThresholdIntegral");
+        Double_t sAna_NumberOfGoodSignals = GetObservableValue<int>("NumberOfGoodSignals");
+
         if ((sAna_ThresholdIntegral > fThrIntegralCutRange.X() &&
              sAna_ThresholdIntegral < fThrIntegralCutRange.Y()) &&
             (sAna_NumberOfGoodSignals > fNGoodSignalsCutRange.X() &&
              sAna_NumberOfGoodSignals < fNGoodSignalsCutRange.Y())) {
             // if within energy cut range
+            map<int, Double_t> sAna_thr_integral_map =
+                GetObservableValue<map<int, Double_t>>("thr_integral_map");
 
             for (auto iter = sAna_thr_integral_map.begin(); iter != sAna_thr_integral_map.end(); iter++) {
-                if (fChannelThrIntegral[iter->first] == nullptr) {
-                    fChannelThrIntegral[iter->first] = new TH1D(
-                        Form("h%i", iter->first), Form("h%i", iter->first), 100, 0, fSpecFitRange.Y() * 1.5);
-                }
-
-                fChannelThrIntegral[iter->first]->Fill(iter->second);
+                FillChannelSpectrum(iter->first, iter->second);
             }
         }
     }
 
     else if (fApplyGainCorrection) {
+        map<int, Double_t> sAna_max_amplitude_map =
+            GetObservableValue<map<int, Double_t>>("max_amplitude_map");
+        map<int, Double_t> sAna_thr_integral_map = GetObservableValue<map<int, Double_t>>("thr_integral_map");
+
+        // the gain recorded for a channel, NaN if there is none
+        auto channelGain = [&](int id) {
+            if (id < 0 || id >= (int)fChannelGainTable.size())
+                return std::numeric_limits<Double_t>::quiet_NaN();
+            return fChannelGainTable[id];
+        };
+
         // calculate updated ThresholdIntegral and PeakAmplitudeIntegral applying correction map
         for (auto iter = sAna_max_amplitude_map.begin(); iter != sAna_max_amplitude_map.end(); iter++) {
-            if (fCalib->fChannelGain.count(iter->first)) {
-                iter->second *= fCalib->fChannelGain[iter->first];
+            double gain = channelGain(iter->first);
+            if (!std::isnan(gain)) {
+                iter->second *= gain;
             }
             new_PeakAmplitudeIntegral += iter->second;
         }
 
         for (auto iter = sAna_thr_integral_map.begin(); iter != sAna_thr_integral_map.end(); iter++) {
-            if (fCalib->fChannelGain.count(iter->first)) {
-                iter->second *= fCalib->fChannelGain[iter->first];
+            double gain = channelGain(iter->first);
+            if (!std::isnan(gain)) {
+                iter->second *= gain;
             }
             new_ThresholdIntegral += iter->second;
         }
@@ -136,15 +166,12 @@ TRestEvent* TRestDetectorSingleChannelAnalysisProcess::ProcessEvent(TRestEvent*
         // update charge value in output event
         for (int i = 0; i < fSignalEvent->GetNumberOfSignals(); i++) {
             TRestDetectorSignal* sgn = fSignalEvent->GetSignal(i);
-            if (fCalib->fChannelGain.count(sgn->GetID()) == 0 || fCalib->fChannelGain[sgn->GetID()] == 0) {
+            double gain = channelGain(sgn->GetID());
+            if (std::isnan(gain) || gain == 0) {
                 cout << "warning! unrecorded gain for channel: " << sgn->GetID() << endl;
                 continue;
             }
-            double gain = fCalib->fChannelGain[sgn->GetID()];
-            for (int j = 0; j < sgn->GetNumberOfPoints(); j++) {
-                auto timecharge = sgn->GetPoint(j);
-                sgn->SetPoint(j, timecharge.X(), timecharge.Y() * gain);
-            }
+            sgn->MultiplySignalBy(gain);
         }
     }
 
@@ -156,61 +183,162 @@ TRestEvent* TRestDetectorSingleChannelAnalysisProcess::ProcessEvent(TRestEvent*
 
 void TRestDetectorSingleChannelAnalysisProcess::EndProcess() {
     if (fCreateGainMap) {
+        if (!fAccumulatorSave.empty()) SaveAccumulators(fAccumulatorSave);
         FitChannelGain();
         // SaveGainMetadata(fCalibSave);
     }
 }
 
+// The daq id indexed spectra are filled with the same binning as the TH1D spectra,
+// index 0 and kSpectrumBins + 1 being the underflow and overflow bins
+void TRestDetectorSingleChannelAnalysisProcess::FillChannelSpectrum(int id, double value, bool fill) {
+    if (id < 0) return;
+
+    const size_t stride = kSpectrumBins + 2;
+    if (id >= (int)fChannelEntries.size()) {
+        fChannelEntries.resize(id + 1, -1);
+        fChannelSpectra.resize((id + 1) * stride, 0);
+    }
+    if (fChannelEntries[id] < 0) fChannelEntries[id] = 0;
+    if (!fill) return;
+
+    const double xmax = fSpecFitRange.Y() * 1.5;
+    int bin = kSpectrumBins + 1;
+    if (value < 0) {
+        bin = 0;
+    } else if (value < xmax) {
+        bin = (int)(kSpectrumBins * value / xmax) + 1;
+    }
+
+    fChannelSpectra[id * stride + bin]++;
+    fChannelEntries[id]++;
+}
+
+// The TH1D spectra are created once at the end of the run from the dense storage
+void TRestDetectorSingleChannelAnalysisProcess::BuildChannelSpectra() {
+    const size_t stride = kSpectrumBins + 2;
+    for (int id = 0; id < (int)fChannelEntries.size(); id++) {
+        if (fChannelEntries[id] < 0) continue;
+
+        TH1D* h = fChannelThrIntegral[id];
+        if (h == nullptr) {
+            h = new TH1D(Form("h%i", id), Form("h%i", id), kSpectrumBins, 0, fSpecFitRange.Y() * 1.5);
+            fChannelThrIntegral[id] = h;
+        }
+
+        for (int bin = 0; bin < (int)stride; bin++) {
+            h->SetBinContent(bin, fChannelSpectra[id * stride + bin]);
+        }
+        h->SetEntries(fChannelEntries[id]);
+    }
+}
+
 void TRestDetectorSingleChannelAnalysisProcess::FitChannelGain() {
     cout << "TRestDetectorSingleChannelAnalysisProcess: fitting channel gain..." << endl;
 
+    BuildChannelSpectra();
+
     double channelFitMeanSum = 0;
 
+    // the channels with enough statistics are fitted in parallel, and the results
+    // are collected afterwards in channel order
+    std::vector<int> ids;
+    std::vector<TH1D*> spectra;
     for (auto iter = fChannelThrIntegral.begin(); iter != fChannelThrIntegral.end(); iter++) {
-        TH1D* h = iter->second;
-        if (h->GetEntries() > 100) {
-            // direct fit
-            double middle = (fSpecFitRange.X() + fSpecFitRange.Y()) / 2;
-            double range = (fSpecFitRange.Y() - fSpecFitRange.X()) / 2;
-            TFitResultPtr r = h->Fit("gaus", "QS", "", fSpecFitRange.X(), fSpecFitRange.Y());
-            if (r != -1) {
-                const double* results = r->GetParams();
-                double mean = results[1];
-                double sigma = results[2];
-
-                if (mean > middle - range / 1.2 && mean < middle + range / 1.2 && sigma / mean < 0.5) {
-                    fChannelFitMean[iter->first] = mean;
-                    channelFitMeanSum += mean;
-                    fChannelGainError[iter->first] = sigma / mean;
-                    cout << iter->first << ", mean: " << mean << ", error: " << sigma / mean << endl;
-                    continue;
-                }
-            }
+        if (iter->second->GetEntries() > 100) {
+            ids.push_back(iter->first);
+            spectra.push_back(iter->second);
+        }
+    }
 
-            // if fit with gaus failed, we use TSpectrum to find the peak
-            TSpectrum spc;
-            int n = spc.Search(h);
-            double* peaks = spc.GetPositionX();
-            double min = std::numeric_limits<Double_t>::max();
-            int minpos = 0;
-            for (int i = 0; i < n; i++) {
-                double dist = abs(peaks[i] - middle);
-                if (dist < min) {
-                    min = dist;
-                    minpos = i;
-                }
+    // status is 1 for a gaus fit, 2 for a TSpectrum peak, 0 for a bad channel
+    std::vector<int> status(ids.size(), 0);
+    std::vector<double> position(ids.size(), 0);
+    std::vector<double> error(ids.size(), 0);
+    std::vector<int> npeaks(ids.size(), 0);
+
+    double middle = (fSpecFitRange.X() + fSpecFitRange.Y()) / 2;
+    double range = (fSpecFitRange.Y() - fSpecFitRange.X()) / 2;
+
+    auto fit = [&](size_t c) {
+        TH1D* h = spectra[c];
+
+        // direct fit
+        TF1 gaus(Form("gaus_%i", ids[c]), "gaus", fSpecFitRange.X(), fSpecFitRange.Y(),
+                 TF1::EAddToList::kNo);
+        TFitResultPtr r = h->Fit(&gaus, "QSR");
+        if (r != -1) {
+            const double* results = r->GetParams();
+            double mean = results[1];
+            double sigma = results[2];
+
+            if (mean > middle - range / 1.2 && mean < middle + range / 1.2 && sigma / mean < 0.5) {
+                status[c] = 1;
+                position[c] = mean;
+                error[c] = sigma / mean;
+                return;
             }
-            if (min < range * 2) {
-                fChannelFitMean[iter->first] = peaks[minpos];
-                channelFitMeanSum += peaks[minpos];
-                fChannelGainError[iter->first] = 1;
-                cout << iter->first << ", peak position: " << peaks[minpos] << ", total peaks: " << n << endl;
-                continue;
+        }
+
+        // if fit with gaus failed, we use TSpectrum to find the peak
+        TSpectrum spc;
+        int n = spc.Search(h, 2, "goff");
+        double* peaks = spc.GetPositionX();
+        double min = std::numeric_limits<Double_t>::max();
+        int minpos = 0;
+        for (int i = 0; i < n; i++) {
+            double dist = abs(peaks[i] - middle);
+            if (dist < min) {
+                min = dist;
+                minpos = i;
             }
+        }
+        if (min < range * 2) {
+            status[c] = 2;
+            position[c] = peaks[minpos];
+            error[c] = 1;
+            npeaks[c] = n;
+        }
+    };
+
+    // the fits are done serially if the default minimizer is not thread safe
+    int nThreads = fFitThreads > 0 ? fFitThreads : (int)std::thread::hardware_concurrency();
+    if (nThreads > 1 && !TRestDetectorSignalEvent::CanFitInThreads()) {
+        RESTWarning << "the default minimizer "
+                    << ROOT::Math::MinimizerOptions::DefaultMinimizerType()
+                    << " is not thread safe, the channel spectra are fitted serially" << RESTendl;
+        nThreads = 1;
+    }
+
+    if (nThreads <= 1 || ids.size() < 2) {
+        for (size_t c = 0; c < ids.size(); c++) fit(c);
+    } else {
+        ROOT::EnableThreadSafety();
 
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t c = next++; c < ids.size(); c = next++) fit(c);
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < std::min(nThreads, (int)ids.size()); t++) threads.emplace_back(worker);
+        for (auto& thread : threads) thread.join();
+    }
+
+    for (size_t c = 0; c < ids.size(); c++) {
+        if (status[c] == 0) {
             // it is very bad channel, we prompt a warning
-            cout << iter->first << ", too bad to fit" << endl;
+            cout << ids[c] << ", too bad to fit" << endl;
+            continue;
         }
+
+        fChannelFitMean[ids[c]] = position[c];
+        channelFitMeanSum += position[c];
+        fChannelGainError[ids[c]] = error[c];
+        if (status[c] == 1)
+            cout << ids[c] << ", mean: " << position[c] << ", error: " << error[c] << endl;
+        else
+            cout << ids[c] << ", peak position: " << position[c] << ", total peaks: " << npeaks[c] << endl;
     }
 
     double meanmean = channelFitMeanSum / fChannelFitMean.size();
@@ -225,6 +353,108 @@ void TRestDetectorSingleChannelAnalysisProcess::FitChannelGain() {
             iter->second = meanmean / fChannelFitMean[iter->first];
         }
     }
+
+    // the result is written into the gain map of the run, that is created if not present
+    if (fCalib == nullptr) {
+        fCalib = new TRestDetectorGainMap();
+        fCalib->SetName("ChannelCalibration");
+        if (fRunInfo != nullptr) fRunInfo->AddMetadata(fCalib);
+    }
+    fCalib->fChannelGain = fChannelGain;
+}
+
+// The channel spectra are the raw accumulators of the gain calibration. They are saved
+// together with the readout channel list, so that the spectra of several runs processed
+// separately can be added with AddAccumulators before a single call to FitChannelGain.
+void TRestDetectorSingleChannelAnalysisProcess::SaveAccumulators(string filename) {
+    BuildChannelSpectra();
+
+    std::vector<int> readoutChannels;
+    for (auto iter = fChannelGain.begin(); iter != fChannelGain.end(); iter++)
+        readoutChannels.push_back(iter->first);
+
+    TDirectory* dir = gDirectory;
+    TFile* f = TFile::Open(filename.c_str(), "RECREATE");
+    if (f == nullptr || f->IsZombie()) {
+        RESTError << "cannot create accumulator file: " << filename << RESTendl;
+        delete f;
+        dir->cd();
+        return;
+    }
+
+    TNamed("accumulator", ClassName()).Write();
+    f->WriteObject(&readoutChannels, "readoutChannels");
+    for (auto iter = fChannelThrIntegral.begin(); iter != fChannelThrIntegral.end(); iter++)
+        iter->second->Write(Form("h%i", iter->first));
+
+    f->Close();
+    delete f;
+    dir->cd();
+
+    cout << "TRestDetectorSingleChannelAnalysisProcess: channel spectra saved to " << filename << endl;
+}
+
+// It adds the channel spectra saved by SaveAccumulators to the ones of this process
+Bool_t TRestDetectorSingleChannelAnalysisProcess::AddAccumulators(string filename) {
+    TDirectory* dir = gDirectory;
+    TFile* f = TFile::Open(filename.c_str());
+    if (f == nullptr || f->IsZombie()) {
+        RESTError << "cannot open accumulator file: " << filename << RESTendl;
+        delete f;
+        dir->cd();
+        return false;
+    }
+
+    bool ok = true;
+    TNamed* type = (TNamed*)f->Get("accumulator");
+    if (type == nullptr || (string)type->GetTitle() != ClassName()) {
+        RESTError << "not a " << ClassName() << " accumulator file: " << filename << RESTendl;
+        ok = false;
+    }
+
+    if (ok) {
+        std::vector<int>* readoutChannels = nullptr;
+        f->GetObject("readoutChannels", readoutChannels);
+        if (readoutChannels != nullptr) {
+            for (auto id : *readoutChannels) {
+                if (fChannelGain.count(id) == 0) {
+                    fChannelGain[id] = 1;
+                    fChannelGainError[id] = 1;
+                }
+                FillChannelSpectrum(id, 0, false);
+            }
+        }
+        delete readoutChannels;
+
+        const size_t stride = kSpectrumBins + 2;
+        TIter next(f->GetListOfKeys());
+        while (TKey* key = (TKey*)next()) {
+            if ((string)key->GetClassName() != "TH1D") continue;
+
+            TH1D* h = (TH1D*)key->ReadObj();
+            if (h->GetNbinsX() != kSpectrumBins || h->GetXaxis()->GetXmax() != fSpecFitRange.Y() * 1.5) {
+                RESTError << "inconsistent spectrum binning in accumulator file: " << filename << RESTendl;
+                delete h;
+                ok = false;
+                break;
+            }
+
+            int id = atoi(key->GetName() + 1);
+            FillChannelSpectrum(id, 0, false);
+            for (size_t bin = 0; bin < stride; bin++) {
+                fChannelSpectra[id * stride + bin] += h->GetBinContent(bin);
+            }
+            fChannelEntries[id] += (Long64_t)h->GetEntries();
+            delete h;
+        }
+    }
+
+    delete type;
+    f->Close();
+    delete f;
+    dir->cd();
+
+    return ok;
 }
 
 /*** This should not be done. The framework saves any metadata structure inside of the
@@ -315,4 +545,6 @@ void TRestDetectorSingleChannelAnalysisProcess::InitFromConfigFile() {
     fNGoodSignalsCutRange = StringTo2DVector(GetParameter("nGoodSignalsRange", "(4,14)"));
     fSpecFitRange = StringTo2DVector(GetParameter("specFitRange", "(1e4,2e4)"));
     fCalibSave = GetParameter("save", "calib.root");
+    fAccumulatorSave = GetParameter("accumulatorSave", "");
+    fFitThreads = StringToInteger(GetParameter("fitThreads", "1"));
 }
@@ -116,7 +116,7 @@ TRestDetectorTriggerAnalysisProcess::TRestDetectorTriggerAnalysisProcess(const c
 ///////////////////////////////////////////////
 /// \brief Default destructor
 ///
-TRestDetectorTriggerAnalysisProcess::~TRestDetectorTriggerAnalysisProcess() { delete fSignalEvent; }
+TRestDetectorTriggerAnalysisProcess::~TRestDetectorTriggerAnalysisProcess() {}
 
 ///////////////////////////////////////////////
 /// \brief Function to load the default config in absence of RML input
@@ -131,7 +131,7 @@ void TRestDetectorTriggerAnalysisProcess::Initialize() {
     SetSectionName(this->ClassName());
     SetLibraryVersion(LIBRARY_VERSION);
 
-    fSignalEvent = new TRestDetectorSignalEvent();
+    fSignalEvent = nullptr;
 }
 
 ///////////////////////////////////////////////
@@ -167,14 +167,75 @@ void TRestDetectorTriggerAnalysisProcess::InitProcess() {
     }
 }
 
+///////////////////////////////////////////////
+/// \brief It builds the summed waveform of all the signals of the given event on the
+/// sampling grid, in the bin range [firstBin, lastBin], as prefix sums.
+///
+/// The charge found exactly at a sampling time and the charge found between two
+/// sampling times are accumulated separately, so that GetWindowIntegral gives the
+/// same result as TRestDetectorSignalEvent::GetIntegralWithTime, where both window
+/// limits are included.
+///
+void TRestDetectorTriggerAnalysisProcess::FillSummedWaveform(const TRestDetectorSignalEvent& event,
+                                                             Int_t firstBin, Int_t lastBin) {
+    fFirstBin = firstBin;
+    const Int_t nBins = lastBin - firstBin + 1;
+
+    fGridChargeSum.assign(nBins + 1, 0);
+    fBinChargeSum.assign(nBins + 1, 0);
+
+    // The signals are only read, so the event extrema are kept
+    for (int s = 0; s < event.GetNumberOfSignals(); s++) {
+        const TRestDetectorSignal* signal = event.GetSignal(s);
+        for (int n = 0; n < signal->GetNumberOfPoints(); n++) {
+            const Double_t time = signal->GetTime(n);
+
+            Int_t bin = (Int_t)TMath::Floor(time / fSampling);
+            if (bin * fSampling > time) bin--;
+            if ((bin + 1) * fSampling <= time) bin++;
+
+            const Int_t index = bin - firstBin;
+            if (index < 0 || index >= nBins) {
+                continue;
+            }
+
+            if (bin * fSampling == time) {
+                fGridChargeSum[index + 1] += signal->GetData(n);
+            } else {
+                fBinChargeSum[index + 1] += signal->GetData(n);
+            }
+        }
+    }
+
+    for (int index = 1; index <= nBins; index++) {
+        fGridChargeSum[index] += fGridChargeSum[index - 1];
+        fBinChargeSum[index] += fBinChargeSum[index - 1];
+    }
+}
+
+///////////////////////////////////////////////
+/// \brief It returns the charge of the summed waveform in the time window
+/// [startBin * fSampling, endBin * fSampling], using the prefix sums filled by
+/// FillSummedWaveform.
+///
+Double_t TRestDetectorTriggerAnalysisProcess::GetWindowIntegral(Int_t startBin, Int_t endBin) const {
+    const Int_t nBins = fGridChargeSum.size() - 1;
+    const Int_t from = std::max(0, std::min(nBins, startBin - fFirstBin));
+    const Int_t gridTo = std::max(0, std::min(nBins, endBin - fFirstBin + 1));
+    const Int_t binTo = std::max(0, std::min(nBins, endBin - fFirstBin));
+
+    Double_t integral = 0;
+    if (gridTo > from) integral += fGridChargeSum[gridTo] - fGridChargeSum[from];
+    if (binTo > from) integral += fBinChargeSum[binTo] - fBinChargeSum[from];
+    return integral;
+}
+
 ///////////////////////////////////////////////
 /// \brief The main processing event function
 ///
 TRestEvent* TRestDetectorTriggerAnalysisProcess::ProcessEvent(TRestEvent* inputEvent) {
-    TRestDetectorSignalEvent* fInputSignalEvent = (TRestDetectorSignalEvent*)inputEvent;
-    fSignalEvent->SetEventInfo(fInputSignalEvent);
-    for (int sgnl = 0; sgnl < fInputSignalEvent->GetNumberOfSignals(); sgnl++)
-        fSignalEvent->AddSignal(*fInputSignalEvent->GetSignal(sgnl));
+    // The input event is only read, so it is analyzed in place and passed through unchanged
+    fSignalEvent = (TRestDetectorSignalEvent*)inputEvent;
 
     vector<Double_t> integral;
     for (unsigned int i = 0; i < fIntegralObservables.size(); i++) integral.push_back(0);
@@ -184,16 +245,27 @@ TRestEvent* TRestDetectorTriggerAnalysisProcess::ProcessEvent(TRestEvent* inputE
 
     Int_t triggerStarts = 0;
 
+    // The event charge is summed once on the sampling grid, so that each window integral is O(1)
+    if (fSignalEvent->GetMinTime() <= fSignalEvent->GetMaxTime()) {
+        const Int_t minTime = (Int_t)TMath::Floor(fSignalEvent->GetMinTime() / fSampling);
+        const Int_t maxTime = (Int_t)TMath::Floor(fSignalEvent->GetMaxTime() / fSampling) + 1;
+        FillSummedWaveform(*fSignalEvent, std::min(minTime, minT - fADCLength / 2),
+                           std::max(maxTime, maxT + fADCLength));
+    } else {
+        fGridChargeSum.assign(1, 0);
+        fBinChargeSum.assign(1, 0);
+    }
+
     unsigned int counter = 0;
     unsigned int nObs = fIntegralObservables.size();
     for (int i = minT - fADCLength / 2; i <= maxT && counter < nObs; i++) {
-        Double_t en = fSignalEvent->GetIntegralWithTime(i * fSampling, (i + fADCLength / 2) * fSampling);
+        Double_t en = GetWindowIntegral(i, i + fADCLength / 2);
 
         for (unsigned int n = 0; n < nObs; n++)
             if (integral[n] == 0 && en > fThreshold[n]) {
                 // We define the trigger start only for the first threshold definition
                 if (n == 0) triggerStarts = i;
-                integral[n] = fSignalEvent->GetIntegralWithTime(i * fSampling, (i + fADCLength) * fSampling);
+                integral[n] = GetWindowIntegral(i, i + fADCLength);
             }
 
         // Break condition
@@ -211,7 +283,5 @@ TRestEvent* TRestDetectorTriggerAnalysisProcess::ProcessEvent(TRestEvent* inputE
     SetObservableValue("RawIntegral", full);
     SetObservableValue("TriggerStarts", triggerStarts);
 
-    if (fSignalEvent->GetNumberOfSignals() <= 0) return fSignalEvent;
-
     return fSignalEvent;
 }
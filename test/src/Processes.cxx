@@ -1,9 +1,30 @@
 
+#include <TFile.h>
+#include <TH1D.h>
+#include <TH2F.h>
+#include <TH3F.h>
+#include <TRandom3.h>
 #include <TRestDetectorAvalancheProcess.h>
 #include <TRestDetectorElectronDiffusionProcess.h>
+#include <TRestDetectorHits3DReconstructionProcess.h>
+#include <TRestDetectorHitsAffineTransformationProcess.h>
+#include <TRestDetectorHitsGainCorrectionProcess.h>
+#include <TRestDetectorHitsReductionProcess.h>
+#include <TRestDetectorPositionMappingProcess.h>
+#include <TRestDetectorSignalNoiseProcess.h>
+#include <TRestDetectorSignalPedestalProcess.h>
+#include <TRestDetectorSignalRecoveryProcess.h>
+#include <TRestDetectorSignalGainCorrectionProcess.h>
+#include <TRestDetectorSignalToHitsProcess.h>
+#include <TRestDetectorSignalZeroSuppressionProcess.h>
+#include <TRestDetectorSingleChannelAnalysisProcess.h>
+#include <TRestDetectorTriggerAnalysisProcess.h>
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <filesystem>
+#include <map>
+#include <set>
 
 namespace fs = std::filesystem;
 
@@ -11,6 +32,40 @@ using namespace std;
 
 const auto filesPath = fs::path(__FILE__).parent_path().parent_path() / "files";
 const auto restDetectorElectronDiffusionProcess = filesPath / "TRestDetectorElectronDiffusionProcess.rml";
+const auto restDetectorHits3DReconstructionProcess =
+    filesPath / "TRestDetectorHits3DReconstructionProcess.rml";
+const auto restDetectorHitsReductionProcess = filesPath / "TRestDetectorHitsReductionProcess.rml";
+const auto restDetectorSignalNoiseProcess = filesPath / "TRestDetectorSignalNoiseProcess.rml";
+const auto restDetectorSingleChannelAnalysisProcess =
+    filesPath / "TRestDetectorSingleChannelAnalysisProcess.rml";
+
+// Channel spectra with a gaussian peak of different position for each channel
+map<int, vector<double>> GenerateChannelValues(int nChannels, int nEntries) {
+    TRandom3 random(7);
+    map<int, vector<double>> values;
+    for (int id = 0; id < nChannels; id++) {
+        const double peak = 1.5e4 * (0.9 + 0.2 * id / nChannels);
+        for (int n = 0; n < nEntries; n++) values[id].push_back(random.Gaus(peak, 1e3));
+    }
+    return values;
+}
+
+// It writes the values in the accumulator format of TRestDetectorSingleChannelAnalysisProcess, taking
+// one of every `step` values starting at `first`
+void WriteChannelAccumulators(const string& filename, const map<int, vector<double>>& values, double xmax,
+                              size_t first = 0, size_t step = 1) {
+    TFile file(filename.c_str(), "RECREATE");
+    TNamed("accumulator", "TRestDetectorSingleChannelAnalysisProcess").Write();
+    vector<int> readoutChannels;
+    for (const auto& [id, channelValues] : values) {
+        readoutChannels.push_back(id);
+        TH1D h(Form("h%i", id), Form("h%i", id), 100, 0, xmax);
+        for (size_t n = first; n < channelValues.size(); n += step) h.Fill(channelValues[n]);
+        h.Write();
+    }
+    file.WriteObject(&readoutChannels, "readoutChannels");
+    file.Close();
+}
 
 TEST(DetectorLib, TestFiles) {
     cout << "Test files path: " << filesPath << endl;
@@ -36,3 +91,988 @@ TEST(TRestDetectorElectronDiffusionProcess, FromRml) {
 
     process.PrintMetadata();
 }
+
+TEST(TRestDetectorHitsAffineTransformationProcess, Composition) {
+    TRestDetectorHitsAffineTransformationProcess process;
+
+    EXPECT_TRUE(process.GetProcessName() == (std::string) "hitsAffineTransformation");
+
+    process.AddSpecular({0, 1, 0}, {0, 2, 0});
+    process.AddRotation(TMath::Pi() / 2, {0, 0, 1}, {1, 0, 0});
+    process.AddTranslation({5, 5, 0});
+    process.AddNormalization(0.5);
+
+    process.PrintMetadata();
+
+    // (1,3,4) -> reflected on y=2 -> (1,1,4) -> rotated around (1,0,0) -> (0,0,4) -> translated
+    const TVector3 position = process.Transform({1, 3, 4});
+    EXPECT_NEAR(position.X(), 5, 1e-9);
+    EXPECT_NEAR(position.Y(), 5, 1e-9);
+    EXPECT_NEAR(position.Z(), 4, 1e-9);
+    EXPECT_DOUBLE_EQ(process.GetEnergyScale(), 0.5);
+}
+
+TEST(TRestDetectorTriggerAnalysisProcess, SummedWaveform) {
+    TRestDetectorTriggerAnalysisProcess process;
+    const Double_t sampling = process.GetSampling();
+
+    // Even channels on the sampling grid, odd channels between sampling times
+    TRestDetectorSignalEvent event;
+    for (int id = 0; id < 4; id++) {
+        for (int i = 0; i < 50; i++) {
+            const Double_t time = (10 * id + i + (id % 2) * 0.37) * sampling;
+            event.AddChargeToSignal(id, time, 1 + (7 * i + id) % 13);
+        }
+    }
+
+    const Int_t first = -5;
+    const Int_t last = 120;
+    process.FillSummedWaveform(event, first, last);
+
+    // The window integrals are the ones of the time window integration over all signals
+    for (int start = first - 3; start <= last; start++) {
+        for (int width : {0, 1, 5, 32}) {
+            const Double_t reference =
+                event.GetIntegralWithTime(start * sampling, (start + width) * sampling);
+            EXPECT_NEAR(process.GetWindowIntegral(start, start + width), reference, 1e-9);
+        }
+    }
+}
+
+TEST(TRestDetectorSignalRecoveryProcess, RecoverChannel) {
+    TRestDetectorReadoutModule module;
+    for (int n = 0; n < 10; n++) {
+        TRestDetectorReadoutChannel channel;
+        channel.SetDaqID(100 + n);
+        module.AddChannel(channel);
+    }
+    module.SetMinMaxDaqIDs();
+    TRestDetectorReadoutPlane plane;
+    plane.AddModule(module);
+    TRestDetectorReadout readout;
+    readout.AddReadoutPlane(plane);
+
+    TRestDetectorSignalRecoveryProcess process;
+    process.SetReadout(&readout);
+    process.SetChannelIds({104});
+
+    // The dead channel is the first signal of the event
+    TRestDetectorSignalEvent input;
+    input.AddChargeToSignal(104, 0, 3);
+    for (int id : {103, 105, 107}) {
+        for (int i = 0; i < 5; i++) {
+            input.AddChargeToSignal(id, i, id - 100 + i);
+        }
+    }
+
+    for (int event = 0; event < 2; event++) {
+        auto output = (TRestDetectorSignalEvent*)process.ProcessEvent(&input);
+        ASSERT_TRUE(output != &input);
+        EXPECT_EQ(output->GetNumberOfSignals(), 4);
+
+        const TRestDetectorSignal* recovered = output->GetSignalById(104);
+        ASSERT_TRUE(recovered != nullptr);
+        ASSERT_EQ(recovered->GetNumberOfPoints(), 5);
+        for (int i = 0; i < 5; i++) {
+            EXPECT_NEAR(recovered->GetData(i), 0.5 * (3 + i) + 0.5 * (5 + i), 1e-9);
+        }
+        EXPECT_NEAR(output->GetSignalById(107)->GetIntegral(), 7 * 5 + 10, 1e-9);
+    }
+
+    // The input event is not modified
+    EXPECT_EQ(input.GetNumberOfSignals(), 4);
+    EXPECT_NEAR(input.GetSignalById(104)->GetIntegral(), 3, 1e-9);
+    EXPECT_NEAR(input.GetSignalById(103)->GetData(0), 3, 1e-9);
+}
+
+TEST(TRestDetectorSingleChannelAnalysisProcess, ThreadedFit) {
+    const auto values = GenerateChannelValues(16, 2000);
+    const string filename = (fs::temp_directory_path() / "singleChannelAccumulators.root").string();
+    WriteChannelAccumulators(filename, values, 3e4);
+
+    TRestDetectorSingleChannelAnalysisProcess serial(restDetectorSingleChannelAnalysisProcess.c_str());
+    ASSERT_TRUE(serial.AddAccumulators(filename));
+    serial.FitChannelGain();
+
+    TRestDetectorSingleChannelAnalysisProcess threaded(restDetectorSingleChannelAnalysisProcess.c_str());
+    threaded.SetFitThreads(4);
+    ASSERT_TRUE(threaded.AddAccumulators(filename));
+    threaded.FitChannelGain();
+
+    const auto& gains = serial.GetGainMap()->fChannelGain;
+    ASSERT_EQ(gains.size(), values.size());
+    EXPECT_TRUE(threaded.GetGainMap()->fChannelGain == gains);
+
+    // The gains follow the peak positions, from the lowest to the highest
+    EXPECT_GT(gains.at(0), 1);
+    EXPECT_LT(gains.at(15), 1);
+
+    fs::remove(filename);
+}
+
+TEST(TRestDetectorSingleChannelAnalysisProcess, MergeAccumulators) {
+    const auto values = GenerateChannelValues(8, 3000);
+    const auto path = fs::temp_directory_path();
+    const string single = (path / "singleChannelSingle.root").string();
+    const string first = (path / "singleChannelFirst.root").string();
+    const string second = (path / "singleChannelSecond.root").string();
+    const string merged = (path / "singleChannelMerged.root").string();
+
+    // The input is split in two jobs taking every other value
+    WriteChannelAccumulators(single, values, 3e4);
+    WriteChannelAccumulators(first, values, 3e4, 0, 2);
+    WriteChannelAccumulators(second, values, 3e4, 1, 2);
+
+    TRestDetectorSingleChannelAnalysisProcess singleJob(restDetectorSingleChannelAnalysisProcess.c_str());
+    ASSERT_TRUE(singleJob.AddAccumulators(single));
+    singleJob.FitChannelGain();
+
+    TRestDetectorSingleChannelAnalysisProcess mergedJobs(restDetectorSingleChannelAnalysisProcess.c_str());
+    ASSERT_TRUE(mergedJobs.AddAccumulators(first));
+    ASSERT_TRUE(mergedJobs.AddAccumulators(second));
+    mergedJobs.FitChannelGain();
+
+    const auto& gains = singleJob.GetGainMap()->fChannelGain;
+    ASSERT_EQ(gains.size(), values.size());
+    EXPECT_TRUE(mergedJobs.GetGainMap()->fChannelGain == gains);
+
+    // The merged spectra saved again give the same result
+    mergedJobs.SaveAccumulators(merged);
+    TRestDetectorSingleChannelAnalysisProcess reloaded(restDetectorSingleChannelAnalysisProcess.c_str());
+    ASSERT_TRUE(reloaded.AddAccumulators(merged));
+    reloaded.FitChannelGain();
+    EXPECT_TRUE(reloaded.GetGainMap()->fChannelGain == gains);
+
+    // Accumulators of a different spectrum binning are rejected
+    WriteChannelAccumulators(first, values, 4e4);
+    TRestDetectorSingleChannelAnalysisProcess inconsistent(restDetectorSingleChannelAnalysisProcess.c_str());
+    EXPECT_FALSE(inconsistent.AddAccumulators(first));
+
+    for (const auto& filename : {single, first, second, merged}) fs::remove(filename);
+}
+
+TEST(TRestDetectorPositionMappingProcess, MergeAccumulators) {
+    const auto path = fs::temp_directory_path();
+    const string single = (path / "positionMappingSingle.root").string();
+    const string first = (path / "positionMappingFirst.root").string();
+    const string second = (path / "positionMappingSecond.root").string();
+
+    // Events with a gain growing along x, split in two jobs taking every other event
+    vector<TH2D> sums(3, TH2D("areaThrIntegralSum", "", 4, -10, 10, 4, -10, 10));
+    vector<TH2D> counts(3, TH2D("areaCounts", "", 4, -10, 10, 4, -10, 10));
+    TRandom3 random(11);
+    for (int n = 0; n < 8000; n++) {
+        const double x = random.Uniform(-10, 10);
+        const double y = random.Uniform(-10, 10);
+        const double energy = random.Gaus(1000 * (1 + x / 40), 50);
+        for (int job : {0, 1 + n % 2}) {
+            sums[job].AddBinContent(sums[job].FindBin(x, y), energy);
+            counts[job].AddBinContent(counts[job].FindBin(x, y), 1);
+        }
+    }
+    const vector<string> filenames = {single, first, second};
+    for (int job = 0; job < 3; job++) {
+        TFile file(filenames[job].c_str(), "RECREATE");
+        TNamed("accumulator", "TRestDetectorPositionMappingProcess").Write();
+        sums[job].Write("areaThrIntegralSum");
+        counts[job].Write("areaCounts");
+        file.Close();
+    }
+
+    TRestDetectorPositionMappingProcess singleJob;
+    ASSERT_TRUE(singleJob.AddAccumulators(single));
+    singleJob.FitAreaGain();
+
+    TRestDetectorPositionMappingProcess mergedJobs;
+    ASSERT_TRUE(mergedJobs.AddAccumulators(first));
+    ASSERT_TRUE(mergedJobs.AddAccumulators(second));
+    mergedJobs.FitAreaGain();
+
+    const TH2F* singleMap = singleJob.GetGainMap()->f2DGainMapping;
+    const TH2F* mergedMap = mergedJobs.GetGainMap()->f2DGainMapping;
+    ASSERT_TRUE(singleMap != nullptr && mergedMap != nullptr);
+    ASSERT_EQ(mergedMap->GetNbinsX(), 4);
+    ASSERT_EQ(mergedMap->GetNbinsY(), 4);
+    for (int i = 1; i <= 4; i++) {
+        for (int j = 1; j <= 4; j++) {
+            EXPECT_NEAR(mergedMap->GetBinContent(i, j), singleMap->GetBinContent(i, j), 1e-6);
+        }
+        // The correction is larger where the gain is lower
+        EXPECT_GT(singleMap->GetBinContent(1, i), singleMap->GetBinContent(4, i));
+    }
+
+    for (const auto& filename : filenames) fs::remove(filename);
+}
+
+// The hits of the signal event converted one signal at a time, with the readout position of each
+// signal obtained from the readout, as done before the per-method kernels
+TRestDetectorHitsEvent ReferenceSignalToHits(TRestDetectorSignalEvent& event, TRestDetectorReadout& readout,
+                                             const string& method, Double_t driftVelocity) {
+    const Double_t intWindow = 5;
+    const Double_t threshold = 100;
+
+    TRestDetectorHitsEvent hits;
+    for (int i = 0; i < event.GetNumberOfSignals(); i++) {
+        TRestDetectorSignal* signal = event.GetSignal(i);
+        Int_t planeID, moduleID, channel = -1;
+        readout.GetPlaneModuleChannel(signal->GetSignalID(), planeID, moduleID, channel);
+        if (channel == -1) continue;
+
+        TRestDetectorReadoutPlane* plane = readout.GetReadoutPlaneWithID(planeID);
+        TRestDetectorReadoutModule* mod = plane->GetModuleByID(moduleID);
+        Double_t x = plane->GetX(moduleID, channel);
+        Double_t y = plane->GetY(moduleID, channel);
+        REST_HitType type = XYZ;
+        const TVector2 center(mod->GetSize().X() / 2, mod->GetSize().Y() / 2);
+        if (TMath::IsNaN(x)) {
+            x = mod->GetPlaneCoordinates(center).X();
+            type = YZ;
+        } else if (TMath::IsNaN(y)) {
+            y = mod->GetPlaneCoordinates(center).Y();
+            type = XZ;
+        }
+        auto z = [&](Double_t time) {
+            return plane->GetPosition().Z() + plane->GetNormal().Z() * time * driftVelocity;
+        };
+
+        const Int_t bin = signal->GetMaxIndex();
+        const Int_t prev = bin > 0 ? bin - 1 : bin;
+        const Int_t next = bin < signal->GetNumberOfPoints() - 1 ? bin + 1 : bin;
+        if (method == "onlyMax") {
+            hits.AddHit(x, y, z(signal->GetMaxPeakTime()), signal->GetMaxPeakValue(), 0, type);
+        } else if (method == "tripleMax") {
+            for (int b : {bin, prev, next}) {
+                hits.AddHit(x, y, z(signal->GetTime(b)), signal->GetData(b), 0, type);
+            }
+        } else if (method == "tripleMaxAverage") {
+            Double_t energy = 0;
+            Double_t zSum = 0;
+            for (int b : {bin, prev, next}) {
+                energy += signal->GetData(b);
+                zSum += z(signal->GetTime(b)) * signal->GetData(b);
+            }
+            hits.AddHit(x, y, zSum / energy, energy / 3, 0, type);
+        } else if (method == "gaussFit") {
+            const auto peak = signal->GetPeakGauss();
+            if (peak) hits.AddHit(x, y, z(peak->first), peak->second, 0, type);
+        } else if (method == "qCenter") {
+            Double_t energy = 0;
+            Double_t distance = 0;
+            for (int j = 0; j < signal->GetNumberOfPoints(); j++) {
+                energy += signal->GetData(j);
+                distance += signal->GetTime(j) * driftVelocity * signal->GetData(j);
+            }
+            hits.AddHit(x, y, plane->GetPosition().Z() + plane->GetNormal().Z() * distance / energy,
+                        energy / signal->GetNumberOfPoints(), 0, type);
+        } else if (method == "all") {
+            for (int j = 0; j < signal->GetNumberOfPoints(); j++)
+                hits.AddHit(x, y, z(signal->GetTime(j)), signal->GetData(j), 0, type);
+        } else if (method == "intwindow") {
+            map<int, pair<int, Double_t>> windows;
+            for (int j = 0; j < signal->GetNumberOfPoints(); j++) {
+                auto& window = windows[(int)(signal->GetTime(j) / intWindow)];
+                window.first++;
+                window.second += signal->GetData(j);
+            }
+            for (const auto& [index, window] : windows) {
+                const Double_t energy = window.second / window.first;
+                if (energy < threshold) continue;
+                hits.AddHit(x, y, z(index * intWindow + intWindow / 2), energy, 0, type);
+            }
+        }
+    }
+    return hits;
+}
+
+TEST(TRestDetectorSignalToHitsProcess, Methods) {
+    // A pad, a strip along x and a strip along y
+    TRestDetectorReadoutModule module;
+    module.SetModuleID(0);
+    module.SetSize({30, 30});
+    module.SetOrigin({5, -5});
+    const vector<pair<TVector2, TVector2>> pixels = {{{3, 3}, {3, 3}}, {{0, 9}, {30, 1}}, {{12, 0}, {1, 30}}};
+    for (size_t n = 0; n < pixels.size(); n++) {
+        TRestDetectorReadoutPixel pixel;
+        pixel.SetOrigin(pixels[n].first);
+        pixel.SetSize(pixels[n].second);
+        TRestDetectorReadoutChannel channel;
+        channel.SetChannelID(n);
+        channel.SetDaqID(10 + n);
+        channel.AddPixel(pixel);
+        module.AddChannel(channel);
+    }
+    module.SetMinMaxDaqIDs();
+    TRestDetectorReadoutPlane plane;
+    plane.SetID(0);
+    plane.SetPosition({0, 0, -50});
+    plane.AddModule(module);
+    TRestDetectorReadout readout;
+    readout.AddReadoutPlane(plane);
+
+    // Gaussian pulses on the three channels, and a channel that is not in the readout
+    TRestDetectorSignalEvent event;
+    for (int id : {10, 11, 12, 99}) {
+        for (int i = 0; i < 60; i++) {
+            const Double_t time = 0.2 * i;
+            event.AddChargeToSignal(id, time, 20 + 300 * id / 10. * exp(-pow(time - 2 - id % 10, 2) / 2));
+        }
+    }
+
+    for (const string method :
+         {"onlyMax", "tripleMax", "tripleMaxAverage", "gaussFit", "qCenter", "all", "intwindow"}) {
+        TRestDetectorSignalToHitsProcess process;
+        process.SetReadout(&readout);
+        process.SetMethod(method);
+        process.SetDriftVelocity(2);
+        process.InitProcess();
+
+        auto hits = (TRestDetectorHitsEvent*)process.ProcessEvent(&event);
+        ASSERT_TRUE(hits != nullptr);
+        const TRestDetectorHitsEvent reference = ReferenceSignalToHits(event, readout, method, 2);
+        ASSERT_EQ(hits->GetNumberOfHits(), reference.GetNumberOfHits());
+        EXPECT_GT(hits->GetNumberOfHits(), 0u);
+
+        for (size_t n = 0; n < hits->GetNumberOfHits(); n++) {
+            EXPECT_NEAR(hits->GetX(n), reference.GetX(n), 1e-9);
+            EXPECT_NEAR(hits->GetY(n), reference.GetY(n), 1e-9);
+            EXPECT_NEAR(hits->GetZ(n), reference.GetZ(n), 1e-9);
+            EXPECT_NEAR(hits->GetEnergy(n), reference.GetEnergy(n), 1e-9);
+            EXPECT_EQ(hits->GetType(n), reference.GetType(n));
+        }
+    }
+}
+
+TEST(TRestDetectorSignalZeroSuppressionProcess, Regions) {
+    TRestDetectorSignalEvent event;
+    for (int i = 0; i < 200; i++) {
+        // A pulse on a noisy baseline, and a signal with only noise
+        event.AddChargeToSignal(1, 0.1 * i, i == 120 ? 200 : 100 + (i % 2 ? 2 : -2));
+        event.AddChargeToSignal(2, 0.1 * i, 100 + (i % 2 ? 2 : -2));
+    }
+    // A sparse signal, not sampled uniformly, with a zero baseline
+    for (int i = 0; i < 80; i++) {
+        event.AddChargeToSignal(3, 3 * i + 0.1 * (i % 7), 50);
+    }
+
+    TRestDetectorSignalZeroSuppressionProcess process;
+    auto output = (TRestDetectorSignalEvent*)process.ProcessEvent(&event);
+    ASSERT_TRUE(output != nullptr);
+    ASSERT_EQ(output->GetNumberOfSignals(), 2);
+
+    // The 5 samples before and the 10 samples after the pulse
+    const TRestDetectorSignal* pulse = output->GetSignalById(1);
+    ASSERT_TRUE(pulse != nullptr);
+    ASSERT_EQ(pulse->GetNumberOfPoints(), 16);
+    for (int n = 0; n < 16; n++) EXPECT_NEAR(pulse->GetTime(n), 0.1 * (115 + n), 1e-9);
+    EXPECT_NEAR(pulse->GetData(5), 200, 1e-9);
+
+    const TRestDetectorSignal* sparse = output->GetSignalById(3);
+    ASSERT_TRUE(sparse != nullptr);
+    EXPECT_EQ(sparse->GetNumberOfPoints(), 80);
+}
+
+TEST(TRestDetectorSignalNoiseProcess, Noise) {
+    // A complete signal, and the same samples with a gap in the middle
+    auto fillEvent = [](TRestDetectorSignalEvent& event, Int_t id, Bool_t gap) {
+        event.SetID(id);
+        for (int i = 0; i < 4096; i++) {
+            if (gap && i >= 1000 && i < 3000) continue;
+            event.AddChargeToSignal(1, 0.5 * i, 100);
+        }
+    };
+
+    TRestDetectorSignalNoiseProcess process(restDetectorSignalNoiseProcess.c_str());
+    process.InitProcess();
+
+    TRestDetectorSignalEvent complete;
+    fillEvent(complete, 5, false);
+    process.ProcessEvent(&complete);
+    const TRestDetectorSignal* noisy = complete.GetSignalById(1);
+    ASSERT_EQ(noisy->GetNumberOfPoints(), 4096);
+    Double_t sum = 0;
+    Double_t sum2 = 0;
+    for (int i = 0; i < 4096; i++) {
+        sum += noisy->GetData(i) - 100;
+        sum2 += (noisy->GetData(i) - 100) * (noisy->GetData(i) - 100);
+    }
+    EXPECT_NEAR(sum / 4096, 0, 1);
+    EXPECT_NEAR(TMath::Sqrt(sum2 / 4096), 10, 0.5);
+
+    // The same seed and event id give the same noise, for each sample also across the gap
+    TRestDetectorSignalNoiseProcess other(restDetectorSignalNoiseProcess.c_str());
+    other.InitProcess();
+    TRestDetectorSignalEvent gapped;
+    fillEvent(gapped, 5, true);
+    other.ProcessEvent(&gapped);
+    const TRestDetectorSignal* gappedNoisy = gapped.GetSignalById(1);
+    ASSERT_EQ(gappedNoisy->GetNumberOfPoints(), 2096);
+    for (int n = 0; n < gappedNoisy->GetNumberOfPoints(); n++) {
+        const Int_t i = n < 1000 ? n : n + 2000;
+        EXPECT_NEAR(gappedNoisy->GetTime(n), 0.5 * i, 1e-9);
+        EXPECT_DOUBLE_EQ(gappedNoisy->GetData(n), noisy->GetData(i));
+    }
+
+    // Another event id gives another noise
+    TRestDetectorSignalEvent next;
+    fillEvent(next, 6, false);
+    process.ProcessEvent(&next);
+    Int_t equal = 0;
+    for (int i = 0; i < 4096; i++) {
+        if (next.GetSignalById(1)->GetData(i) == noisy->GetData(i)) equal++;
+    }
+    EXPECT_EQ(equal, 0);
+}
+
+// The all-pairs merging of TRestDetectorHitsReductionProcess, that the grid based passes replaced
+void ReferenceHitsReduction(TRestHits* hits, Double_t startingDistance, Double_t minimumDistance,
+                            Double_t distanceFactor, Double_t maxNodes) {
+    Double_t distance = startingDistance;
+    while (distance < minimumDistance || hits->GetNumberOfHits() > maxNodes) {
+        Bool_t merged = true;
+        while (merged) {
+            merged = false;
+            for (unsigned int i = 0; i < hits->GetNumberOfHits(); i++) {
+                for (unsigned int j = i + 1; j < hits->GetNumberOfHits(); j++) {
+                    if (hits->GetDistance2(i, j) < distance * distance) {
+                        hits->MergeHits(i, j);
+                        merged = true;
+                    }
+                }
+            }
+        }
+        distance *= distanceFactor;
+    }
+}
+
+TEST(TRestDetectorHitsReductionProcess, Merging) {
+    // A track that needs more than 30 nodes at the minimum distance of 3 mm
+    TRandom3 random(5);
+    TRestDetectorHitsEvent event;
+    TRestDetectorHitsEvent reference;
+    Double_t energy = 0;
+    Double_t weighted[3] = {0, 0, 0};
+
+    // A hit without energy in the middle of the track, that absorbs the hits next to it
+    event.AddHit({62.5, 17 * TMath::Sin(1.5), 17}, 0, 2, XYZ);
+    reference.AddHit({62.5, 17 * TMath::Sin(1.5), 17}, 0, 2, XYZ);
+
+    for (int n = 0; n < 200; n++) {
+        const Double_t t = random.Rndm();
+        const TVector3 position(125 * t + random.Gaus(0, 0.5), 17 * TMath::Sin(3 * t) + random.Gaus(0, 0.5),
+                                34 * t + random.Gaus(0, 0.5));
+        const Double_t hitEnergy = random.Uniform(1, 10);
+        const Double_t time = random.Uniform(0, 5);
+        event.AddHit(position, hitEnergy, time, XYZ);
+        reference.AddHit(position, hitEnergy, time, XYZ);
+        energy += hitEnergy;
+        for (int axis = 0; axis < 3; axis++) weighted[axis] += hitEnergy * position[axis];
+    }
+
+    TRestDetectorHitsReductionProcess process(restDetectorHitsReductionProcess.c_str());
+    process.InitProcess();
+    auto output = (TRestDetectorHitsEvent*)process.ProcessEvent(&event);
+    ReferenceHitsReduction(reference.GetHits(), 0.5, 3, 1.5, 30);
+
+    // The number of nodes and the distance between them are the ones requested
+    const size_t nHits = output->GetNumberOfHits();
+    EXPECT_LE(nHits, 30);
+    EXPECT_GT(nHits, 1);
+    for (size_t i = 0; i < nHits; i++) {
+        for (size_t j = i + 1; j < nHits; j++) EXPECT_GE(output->GetDistance2(i, j), 2 * 2);
+    }
+
+    // The energy and the energy weighted mean position are preserved
+    Double_t outputEnergy = 0;
+    Double_t outputWeighted[3] = {0, 0, 0};
+    for (size_t n = 0; n < nHits; n++) {
+        EXPECT_TRUE(std::isfinite(output->GetX(n)) && std::isfinite(output->GetY(n)) &&
+                    std::isfinite(output->GetZ(n)) && std::isfinite(output->GetTime(n)));
+        outputEnergy += output->GetEnergy(n);
+        outputWeighted[0] += output->GetEnergy(n) * output->GetX(n);
+        outputWeighted[1] += output->GetEnergy(n) * output->GetY(n);
+        outputWeighted[2] += output->GetEnergy(n) * output->GetZ(n);
+    }
+    EXPECT_NEAR(outputEnergy, energy, 1e-9 * energy);
+    for (int axis = 0; axis < 3; axis++) {
+        EXPECT_NEAR(outputWeighted[axis] / outputEnergy, weighted[axis] / energy, 1e-9);
+    }
+
+    // The nodes are close to the ones of the all-pairs merging
+    const size_t nReference = reference.GetNumberOfHits();
+    EXPECT_LE(nHits, nReference + 2);
+    EXPECT_LE(nReference, nHits + 2);
+    for (size_t n = 0; n < nHits; n++) {
+        Double_t closest2 = std::numeric_limits<Double_t>::max();
+        for (size_t m = 0; m < nReference; m++) {
+            const TVector3 delta = output->GetPosition(n) - reference.GetPosition(m);
+            closest2 = TMath::Min(closest2, delta.Mag2());
+        }
+        EXPECT_LT(closest2, 6 * 6);
+    }
+}
+
+// The slice by slice reconstruction of TRestDetectorHits3DReconstructionProcess, with all-pairs stripe
+// crossings and merging, that the sweep over the z slices replaced
+namespace reference3D {
+const double xWidth = 96.7;
+const double yWidth = 96.3;
+const double pitch = 6.2;
+
+struct RegionHit {
+    double x = 0;
+    double y = 0;
+    double e = 0;
+    void Add(const RegionHit& h) {
+        x = (x * e + h.x * h.e) / (e + h.e);
+        y = (y * e + h.y * h.e) / (e + h.e);
+        e += h.e;
+    }
+};
+
+struct StripeHit {
+    double x1 = 0;
+    double x2 = 0;
+    double y1 = 0;
+    double y2 = 0;
+    double e = 0;
+    REST_HitType type = unknown;
+
+    StripeHit(TRestHits* hits, int i) {
+        type = hits->GetType(i);
+        if (type == XZ) {
+            y1 = hits->GetY(i) - yWidth;
+            y2 = hits->GetY(i) + yWidth;
+            x1 = hits->GetX(i);
+            x2 = hits->GetX(i);
+        } else if (type == YZ) {
+            y1 = hits->GetY(i);
+            y2 = hits->GetY(i);
+            x1 = hits->GetX(i) - xWidth;
+            x2 = hits->GetX(i) + xWidth;
+        } else {
+            return;
+        }
+        e = hits->GetEnergy(i);
+    }
+
+    static bool IsRectCross(const StripeHit& s1, const StripeHit& s2) {
+        return min(s1.x1, s1.x2) <= max(s2.x1, s2.x2) && min(s2.x1, s2.x2) <= max(s1.x1, s1.x2) &&
+               min(s1.y1, s1.y2) <= max(s2.y1, s2.y2) && min(s2.y1, s2.y2) <= max(s1.y1, s1.y2);
+    }
+
+    static bool IsLineSegmentCross(const StripeHit& s1, const StripeHit& s2) {
+        return ((s2.x1 - s1.x1) * (s2.y1 - s2.y2) - (s2.y1 - s1.y1) * (s2.x1 - s2.x2)) *
+                       ((s2.x1 - s1.x2) * (s2.y1 - s2.y2) - (s2.y1 - s1.y2) * (s2.x1 - s2.x2)) <
+                   0 ||
+               ((s1.x1 - s2.x1) * (s1.y1 - s1.y2) - (s1.y1 - s2.y1) * (s1.x1 - s1.x2)) *
+                       ((s1.x1 - s2.x2) * (s1.y1 - s1.y2) - (s1.y1 - s2.y2) * (s1.x1 - s1.x2)) <
+                   0;
+    }
+
+    static RegionHit Cross(const StripeHit& s1, const StripeHit& s2) {
+        RegionHit hit;
+        if (s1.type * s2.type != XZ * YZ || s1.e == 0 || s2.e == 0) return hit;
+        if (!IsRectCross(s1, s2) || !IsLineSegmentCross(s1, s2)) return hit;
+
+        long left = (s2.x2 - s2.x1) * (s1.y1 - s1.y2) - (s1.x2 - s1.x1) * (s2.y1 - s2.y2);
+        long right = (s1.y1 - s2.y1) * (s1.x2 - s1.x1) * (s2.x2 - s2.x1) +
+                     s2.x1 * (s2.y2 - s2.y1) * (s1.x2 - s1.x1) - s1.x1 * (s1.y2 - s1.y1) * (s2.x2 - s2.x1);
+        hit.x = (int)((double)right / (double)left);
+
+        left = (s1.x1 - s1.x2) * (s2.y2 - s2.y1) - (s1.y2 - s1.y1) * (s2.x1 - s2.x2);
+        right = s1.y2 * (s1.x1 - s1.x2) * (s2.y2 - s2.y1) +
+                (s2.x2 - s1.x2) * (s2.y2 - s2.y1) * (s1.y1 - s1.y2) -
+                s2.y2 * (s2.x1 - s2.x2) * (s1.y2 - s1.y1);
+        hit.y = (int)((double)right / (double)left);
+        hit.e = s1.e + s2.e;
+        return hit;
+    }
+};
+
+struct Result {
+    double meanAmbiguity = 0;
+    int nLayers = 0;
+    int skippedSlices = 0;
+};
+
+// The number of energy peaks of the stripe positions, the gaps larger than the pitch separating peaks
+int CountSegments(vector<pair<double, double>>& posE) {
+    sort(posE.begin(), posE.end(), [](const pair<double, double>& p1, const pair<double, double>& p2) {
+        return p1.first < p2.first;
+    });
+    for (unsigned int j = 1; j < posE.size(); j++) {
+        if (posE[j].first - posE[j - 1].first > pitch) {
+            posE.insert(posE.begin() + j, {(posE[j].first + posE[j - 1].first) / 2, 0});
+            j++;
+        }
+    }
+    posE.insert(posE.begin(), {posE.front().first - 1, 0});
+    posE.insert(posE.end(), {posE.back().first + 1, 0});
+
+    int segments = 0;
+    for (unsigned int j = 1; j < posE.size() - 1; j++) {
+        if (posE[j].second > posE[j - 1].second && posE[j].second > posE[j + 1].second) segments++;
+    }
+    return segments;
+}
+
+Result Reconstruct(TRestDetectorHitsEvent& event, double zRange, int maxStripeHits,
+                   TRestDetectorHits3DReconstructionProcess& process, TRestDetectorHitsEvent& output) {
+    event.Sort();
+    TRestHits* hits = event.GetHits();
+    const int nHits = event.GetNumberOfHits();
+
+    Result result;
+    double totalAmbiguity = 0;
+    double lastz = 0;
+    for (int n = 0; n < nHits; n++) {
+        const double z = event.GetZ(n);
+        if (z == lastz) continue;
+        lastz = z;
+
+        // the hits near this z slice, with their weight
+        map<int, double> ids;
+        ids[n] = 1;
+        for (int i = n - 1; i >= 0 && abs(event.GetZ(i) - z) < zRange * 2; i--) {
+            ids[i] = TMath::Gaus(abs(event.GetZ(i) - z), 0, zRange);
+        }
+        for (int i = n + 1; i < nHits && abs(event.GetZ(i) - z) < zRange * 2; i++) {
+            ids[i] = TMath::Gaus(abs(event.GetZ(i) - z), 0, zRange);
+        }
+
+        vector<StripeHit> stripes;
+        for (const auto& [i, weight] : ids) {
+            StripeHit h(hits, i);
+            h.e *= weight;
+            if (h.e == 0) continue;
+            auto same = find_if(stripes.begin(), stripes.end(), [&](const StripeHit& s) {
+                return s.x1 == h.x1 && s.x2 == h.x2 && s.y1 == h.y1 && s.y2 == h.y2;
+            });
+            if (same != stripes.end()) {
+                same->e += h.e;
+            } else {
+                stripes.push_back(h);
+            }
+        }
+
+        if (maxStripeHits > 0 && (int)stripes.size() > maxStripeHits) {
+            result.skippedSlices++;
+            continue;
+        }
+
+        auto crossed = [&](int i) {
+            vector<int> crossedIds;
+            for (int j = 0; j < (int)stripes.size(); j++) {
+                if (j != i && StripeHit::IsRectCross(stripes[i], stripes[j])) crossedIds.push_back(j);
+            }
+            return crossedIds;
+        };
+
+        vector<RegionHit> regions;
+        double layerAmbiguity = 0;
+        set<int> calculated;
+        for (int i = 0; i < (int)stripes.size(); i++) {
+            const vector<int> crossedIds = crossed(i);
+            double crossedEnergy = 0;
+            for (int id : crossedIds) crossedEnergy += stripes[id].e;
+
+            for (int id : crossedIds) {
+                RegionHit region = StripeHit::Cross(stripes[i], stripes[id]);
+                region.e = stripes[i].e * stripes[id].e / crossedEnergy;
+                auto same = find_if(regions.begin(), regions.end(), [&](const RegionHit& r) {
+                    return r.x == region.x && r.y == region.y;
+                });
+                if (same != regions.end()) {
+                    same->e += region.e;
+                } else {
+                    regions.push_back(region);
+                }
+            }
+
+            if (calculated.count(i) != 0 || crossedIds.empty()) continue;
+            calculated.insert(crossedIds.begin(), crossedIds.end());
+            const StripeHit& line = stripes[i];
+            const StripeHit& newLine = stripes[crossedIds[0]];
+            const vector<int> newLineIds = crossed(crossedIds[0]);
+            calculated.insert(newLineIds.begin(), newLineIds.end());
+
+            vector<pair<double, double>> V_PosE;
+            vector<pair<double, double>> H_PosE;
+            if (line.x1 == line.x2) {
+                for (int id : newLineIds) H_PosE.push_back({stripes[id].x1, stripes[id].e});
+            } else if (line.y1 == line.y2) {
+                for (int id : newLineIds) V_PosE.push_back({stripes[id].y1, stripes[id].e});
+            }
+            if (newLine.x1 == newLine.x2) {
+                for (int id : crossedIds) H_PosE.push_back({stripes[id].x1, stripes[id].e});
+            } else if (newLine.y1 == newLine.y2) {
+                for (int id : crossedIds) V_PosE.push_back({stripes[id].y1, stripes[id].e});
+            }
+
+            layerAmbiguity +=
+                process.LogAmbiguity(max(CountSegments(V_PosE), 1), max(CountSegments(H_PosE), 1));
+        }
+        totalAmbiguity += layerAmbiguity;
+
+        // starting from the most energetic region, the regions connected to it are merged
+        vector<RegionHit> merged;
+        set<int> mergedAll;
+        while (mergedAll.size() < regions.size()) {
+            double maxEnergy = 0;
+            int maxPosition = -1;
+            for (int i = 0; i < (int)regions.size(); i++) {
+                if (mergedAll.count(i) == 0 && regions[i].e > maxEnergy) {
+                    maxEnergy = regions[i].e;
+                    maxPosition = i;
+                }
+            }
+            if (maxPosition == -1) break;
+
+            set<int> group = {maxPosition};
+            for (auto g = group.begin(); g != group.end();) {
+                bool inserted = false;
+                for (int j = 0; j < (int)regions.size(); j++) {
+                    const double dx = regions[*g].x - regions[j].x;
+                    const double dy = regions[*g].y - regions[j].y;
+                    if (sqrt(dx * dx + dy * dy) < pitch && regions[*g].e > regions[j].e &&
+                        mergedAll.count(j) == 0) {
+                        inserted |= group.insert(j).second;
+                    }
+                }
+                g = inserted ? group.begin() : next(g);
+            }
+
+            RegionHit h;
+            for (int i : group) {
+                mergedAll.insert(i);
+                h.Add(regions[i]);
+            }
+            merged.push_back(h);
+        }
+        if (!merged.empty()) result.nLayers++;
+
+        for (const auto& h : merged) output.AddHit(h.x, h.y, z, h.e, 0, XYZ);
+    }
+
+    result.meanAmbiguity = totalAmbiguity / result.nLayers;
+    return result;
+}
+}  // namespace reference3D
+
+// Two tracks crossing the XZ and YZ strips, and a z with more strips than the default limit
+void Fill3DReconstructionEvent(TRestDetectorHitsEvent& event) {
+    TRandom3 random(13);
+    for (int z = 1; z <= 30; z++) {
+        for (const int offset : {-60, 30}) {
+            const int x = offset + 6 * (z / 3);
+            const int y = offset / 2 - 6 * (z / 4);
+            for (int k = 0; k < 2; k++) {
+                event.AddHit(x + 6 * k, 0, z, random.Uniform(1, 10), 0, XZ);
+                event.AddHit(0, y + 6 * k, z, random.Uniform(1, 10), 0, YZ);
+            }
+        }
+    }
+    for (int k = -15; k < 15; k++) {
+        event.AddHit(6 * k + 1, 0, 40, random.Uniform(1, 10), 0, XZ);
+        event.AddHit(0, 6 * k + 1, 40, random.Uniform(1, 10), 0, YZ);
+    }
+}
+
+TEST(TRestDetectorHits3DReconstructionProcess, Reference) {
+    const vector<pair<string, int>> configurations = {{"serial", 50}, {"threads", 50}, {"unlimited", 0}};
+    for (const auto& [name, maxStripeHits] : configurations) {
+        TRestDetectorHits3DReconstructionProcess process;
+        process.LoadConfigFromFile(restDetectorHits3DReconstructionProcess.string(), name);
+        process.InitProcess();
+
+        TRestDetectorHitsEvent event;
+        Fill3DReconstructionEvent(event);
+        auto output = (TRestDetectorHitsEvent*)process.ProcessEvent(&event);
+
+        TRestDetectorHitsEvent referenceEvent;
+        TRestDetectorHitsEvent referenceOutput;
+        Fill3DReconstructionEvent(referenceEvent);
+        const auto reference =
+            reference3D::Reconstruct(referenceEvent, 5, maxStripeHits, process, referenceOutput);
+
+        // The slice over the stripe limit is skipped, and the others are reconstructed
+        EXPECT_EQ(reference.skippedSlices, maxStripeHits > 0 ? 1 : 0);
+        EXPECT_GT(reference.nLayers, 25);
+        EXPECT_GT(reference.meanAmbiguity, 0);
+
+        // The sweep over the slices, serial or in threads, gives the same hits as the reference
+        ASSERT_EQ(output->GetNumberOfHits(), referenceOutput.GetNumberOfHits());
+        for (size_t n = 0; n < referenceOutput.GetNumberOfHits(); n++) {
+            EXPECT_NEAR(output->GetX(n), referenceOutput.GetX(n), 1e-9);
+            EXPECT_NEAR(output->GetY(n), referenceOutput.GetY(n), 1e-9);
+            EXPECT_NEAR(output->GetZ(n), referenceOutput.GetZ(n), 1e-9);
+            EXPECT_NEAR(output->GetEnergy(n), referenceOutput.GetEnergy(n),
+                        1e-9 * referenceOutput.GetEnergy(n));
+        }
+        EXPECT_EQ(process.GetNumberOfLayers(), reference.nLayers);
+        EXPECT_NEAR(process.GetMeanAmbiguity(), reference.meanAmbiguity, 1e-9 * reference.meanAmbiguity);
+    }
+}
+
+TEST(TRestDetectorSignalPedestalProcess, Convergence) {
+    // Events of one channel with a gaussian pulse over the pedestal and noise
+    TRandom3 random(11);
+    auto fillEvent = [&](TRestDetectorSignalEvent& event, Double_t pedestal) {
+        for (int i = 0; i < 512; i++) {
+            const Double_t pulse = 400 * TMath::Exp(-0.5 * (i - 256) * (i - 256) / 64.);
+            event.AddChargeToSignal(3, i, pedestal + pulse + random.Gaus(0, 5));
+        }
+    };
+
+    // The default time constant is 100 events
+    TRestDetectorSignalPedestalProcess process;
+    process.InitProcess();
+    EXPECT_EQ(process.GetPedestal(3), 0);
+    EXPECT_EQ(process.GetNoise(3), 0);
+
+    for (const Double_t pedestal : {250., 260.}) {
+        for (int n = 0; n < 600; n++) {
+            TRestDetectorSignalEvent event;
+            event.SetID(n);
+            fillEvent(event, pedestal);
+            process.ProcessEvent(&event);
+
+            // The first event already gives a pedestal close to the real one
+            if (n == 0 && pedestal == 250.) EXPECT_NEAR(process.GetPedestal(3), pedestal, 1);
+            if (n < 599) continue;
+
+            // The pulse does not bias the estimation, that follows the change of pedestal
+            EXPECT_NEAR(process.GetPedestal(3), pedestal, 0.5);
+            EXPECT_NEAR(process.GetNoise(3), 5, 0.25);
+            EXPECT_EQ(process.GetPedestal(4), 0);
+
+            // The pedestal is subtracted from the signal, keeping the pulse
+            const TRestDetectorSignal* signal = event.GetSignalById(3);
+            ASSERT_EQ(signal->GetNumberOfPoints(), 512);
+            Double_t sum = 0;
+            Int_t count = 0;
+            for (int i = 0; i < 512; i++) {
+                if (abs(i - 256) < 64) continue;
+                sum += signal->GetData(i);
+                count++;
+            }
+            EXPECT_NEAR(sum / count, 0, 1);
+            EXPECT_NEAR(signal->GetData(256), 400, 20);
+        }
+    }
+
+    // Without pulse, the noise estimated from the points within the threshold is not biased low
+    TRestDetectorSignalPedestalProcess noiseProcess;
+    noiseProcess.InitProcess();
+    for (int n = 0; n < 600; n++) {
+        TRestDetectorSignalEvent event;
+        event.SetID(n);
+        for (int i = 0; i < 512; i++) {
+            event.AddChargeToSignal(3, i, 250 + random.Gaus(0, 5));
+        }
+        noiseProcess.ProcessEvent(&event);
+    }
+    EXPECT_NEAR(noiseProcess.GetPedestal(3), 250, 0.1);
+    EXPECT_NEAR(noiseProcess.GetNoise(3), 5, 0.05);
+}
+
+TEST(TRestDetectorHitsGainCorrectionProcess, GainMaps) {
+    TH2F map2D("gainMap2D", "", 5, -10, 10, 4, 0, 8);
+    for (int i = 1; i <= 5; i++) {
+        for (int j = 1; j <= 4; j++) map2D.SetBinContent(i, j, 1 + 0.1 * i - 0.05 * j);
+    }
+    const Double_t edges[] = {-10, -7, -2, 0, 6, 10};
+    TH2F variable2D("variableGainMap2D", "", 5, edges, 4, 0, 8);
+    for (int i = 1; i <= 5; i++) {
+        for (int j = 1; j <= 4; j++) variable2D.SetBinContent(i, j, 1 - 0.07 * i + 0.02 * j * j);
+    }
+    TH3F map3D("gainMap3D", "", 3, -10, 10, 3, -10, 10, 4, 0, 100);
+    for (int i = 1; i <= 3; i++) {
+        for (int j = 1; j <= 3; j++) {
+            for (int k = 1; k <= 4; k++) map3D.SetBinContent(i, j, k, 0.8 + 0.1 * i + 0.03 * j * k);
+        }
+    }
+    map3D.SetEntries(36);
+
+    // Hits inside the maps, outside them, and without one coordinate
+    TRestDetectorHitsEvent input;
+    for (double x = -9.5; x < 10; x += 1.3) {
+        for (double y = -0.5; y < 9; y += 0.7) input.AddHit(x, y, 7 * (x + 10) - y, 100, 0, XYZ);
+    }
+    for (const auto& position : vector<TVector3>{{-15, 4, 50}, {25, 4, 50}, {3, -3, -20}, {3, 12, 130}}) {
+        input.AddHit(position, 100, 0, XYZ);
+    }
+    const Double_t nan = std::numeric_limits<Double_t>::quiet_NaN();
+    input.AddHit(3, nan, 50, 100, 0, XZ);
+    input.AddHit(nan, 3, 50, 100, 0, YZ);
+
+    // The reference gain of the closest point inside the map, as given by TH1::Interpolate or by the bin
+    auto referenceGain = [&](TH1* map, Double_t x, Double_t y, Double_t z, Bool_t interpolate) {
+        const Int_t dimension = map->GetDimension();
+        const TAxis* axes[3] = {map->GetXaxis(), map->GetYaxis(), map->GetZaxis()};
+        Double_t position[3] = {x, y, z};
+        for (int d = 0; d < dimension; d++) {
+            if (TMath::IsNaN(position[d])) return 1.;
+            const Double_t low = interpolate ? axes[d]->GetBinCenter(1) : axes[d]->GetXmin();
+            const Double_t high =
+                interpolate ? axes[d]->GetBinCenter(axes[d]->GetNbins()) : axes[d]->GetXmax();
+            position[d] = TMath::Max(low, TMath::Min(position[d], high - 1e-9));
+        }
+        if (!interpolate) return map->GetBinContent(map->FindBin(position[0], position[1], position[2]));
+        if (dimension == 2) return map->Interpolate(position[0], position[1]);
+        return map->Interpolate(position[0], position[1], position[2]);
+    };
+
+    for (TH2F* map : {&map2D, &variable2D}) {
+        for (Bool_t interpolate : {true, false}) {
+            TRestDetectorGainMap calib;
+            calib.f2DGainMapping = map;
+            calib.f3DGainMapping = &map3D;
+
+            TRestDetectorHitsGainCorrectionProcess process;
+            process.SetGainMap(&calib);
+            process.SetInterpolate(interpolate);
+            process.InitProcess();
+
+            auto output = (TRestDetectorHitsEvent*)process.ProcessEvent(&input);
+            ASSERT_EQ(output->GetNumberOfHits(), input.GetNumberOfHits());
+            for (size_t n = 0; n < input.GetNumberOfHits(); n++) {
+                const Double_t x = input.GetX(n);
+                const Double_t y = input.GetY(n);
+                const Double_t z = input.GetZ(n);
+                const Double_t gain =
+                    referenceGain(map, x, y, z, interpolate) * referenceGain(&map3D, x, y, z, interpolate);
+                EXPECT_NEAR(output->GetEnergy(n), 100 * gain, 1e-6);
+            }
+
+            // The XZ and YZ hits are not corrected by maps requiring the missing coordinate
+            const size_t last = input.GetNumberOfHits() - 1;
+            EXPECT_NEAR(output->GetEnergy(last - 1), 100, 1e-9);
+            EXPECT_NEAR(output->GetEnergy(last), 100, 1e-9);
+        }
+    }
+}
+
+TEST(TRestDetectorSignalGainCorrectionProcess, ChannelGains) {
+    TRestDetectorGainMap calib;
+    calib.fChannelGain = {{1, 2.}, {3, 0.5}, {4, 1.}};
+
+    TRestDetectorSignalGainCorrectionProcess process;
+    process.SetGainMap(&calib);
+    process.InitProcess();
+
+    // Channels with a gain, without a gain below the largest id, and beyond the largest id
+    TRestDetectorSignalEvent event;
+    for (int id : {1, 2, 3, 10}) {
+        for (int i = 0; i < 10; i++) event.AddChargeToSignal(id, i, 10 + i);
+    }
+
+    auto output = (TRestDetectorSignalEvent*)process.ProcessEvent(&event);
+    ASSERT_EQ(output->GetNumberOfSignals(), 4);
+    const map<int, double> gains = {{1, 2.}, {2, 1.}, {3, 0.5}, {10, 1.}};
+    for (const auto& [id, gain] : gains) {
+        const TRestDetectorSignal* signal = output->GetSignalById(id);
+        ASSERT_TRUE(signal != nullptr);
+        for (int i = 0; i < 10; i++) EXPECT_NEAR(signal->GetData(i), gain * (10 + i), 1e-9);
+    }
+}
@@ -0,0 +1,129 @@
+
+#include <TRestDetectorGainMap.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+using namespace std;
+
+void FillGainMap(TRestDetectorGainMap& gainMap) {
+    gainMap.relative = true;
+    gainMap.fChannelGain = {{-2, 0.75}, {0, 1.0 / 3}, {5, 1.25}, {1024, 2.5e-3}};
+
+    gainMap.f2DGainMapping = new TH2F("map2D", "", 5, -10, 10, 3, 0, 7.5);
+    gainMap.f2DGainMapping->SetDirectory(nullptr);
+    for (int i = 1; i <= 5; i++) {
+        for (int j = 1; j <= 3; j++) gainMap.f2DGainMapping->SetBinContent(i, j, 1 + 0.1 * i - 0.03 * j);
+    }
+    gainMap.f2DGainMapping->SetEntries(15);
+
+    TH3F* map3D = new TH3F("map3D", "", 2, -5, 5, 3, -6, 6, 4, 0, 100);
+    map3D->SetDirectory(nullptr);
+    for (int i = 1; i <= 2; i++) {
+        for (int j = 1; j <= 3; j++) {
+            for (int k = 1; k <= 4; k++) map3D->SetBinContent(i, j, k, 0.8 + 0.01 * i * j * k);
+        }
+    }
+    map3D->SetEntries(24);
+    gainMap.f3DGainMapping = map3D;
+}
+
+void ExpectSameMap(const TH1* map, const TH1* expected) {
+    ASSERT_TRUE(map != nullptr);
+    EXPECT_EQ(map->GetDimension(), expected->GetDimension());
+    EXPECT_EQ(map->GetEntries(), expected->GetEntries());
+    const TAxis* axes[3] = {map->GetXaxis(), map->GetYaxis(), map->GetZaxis()};
+    const TAxis* expectedAxes[3] = {expected->GetXaxis(), expected->GetYaxis(), expected->GetZaxis()};
+    for (int d = 0; d < expected->GetDimension(); d++) {
+        EXPECT_EQ(axes[d]->GetNbins(), expectedAxes[d]->GetNbins());
+        EXPECT_EQ(axes[d]->GetXmin(), expectedAxes[d]->GetXmin());
+        EXPECT_EQ(axes[d]->GetXmax(), expectedAxes[d]->GetXmax());
+    }
+    for (int bin = 0; bin < expected->GetNcells(); bin++) {
+        if (expected->IsBinUnderflow(bin) || expected->IsBinOverflow(bin)) continue;
+        EXPECT_EQ(map->GetBinContent(bin), expected->GetBinContent(bin));
+    }
+}
+
+TEST(TRestDetectorGainMap, RoundTrip) {
+    TRestDetectorGainMap gainMap;
+    FillGainMap(gainMap);
+
+    const auto path = fs::temp_directory_path();
+    const string textFile = (path / "gainMap.txt").string();
+    const string binaryFile = (path / "gainMap.bin").string();
+    ASSERT_TRUE(gainMap.SaveToText(textFile));
+    ASSERT_TRUE(gainMap.SaveToBinary(binaryFile));
+
+    const vector<pair<string, bool>> files = {{textFile, false}, {binaryFile, true}};
+    for (const auto& [filename, isBinary] : files) {
+        TRestDetectorGainMap read;
+        read.relative = false;
+        EXPECT_TRUE(isBinary ? read.ReadGainBinary(filename) : read.ReadGainText(filename));
+        EXPECT_TRUE(read.relative);
+        EXPECT_EQ(read.fChannelGain, gainMap.fChannelGain);
+        ExpectSameMap(read.f2DGainMapping, gainMap.f2DGainMapping);
+        ExpectSameMap(read.f3DGainMapping, gainMap.f3DGainMapping);
+
+        // The format is recognized from the file contents, and the maps are replaced
+        TRestDetectorGainMap detected;
+        detected.relative = false;
+        EXPECT_TRUE(detected.ReadGainFile(filename));
+        EXPECT_TRUE(detected.ReadGainFile(filename));
+        EXPECT_TRUE(detected.relative);
+        EXPECT_EQ(detected.fChannelGain, gainMap.fChannelGain);
+        ExpectSameMap(detected.f2DGainMapping, gainMap.f2DGainMapping);
+        ExpectSameMap(detected.f3DGainMapping, gainMap.f3DGainMapping);
+    }
+
+    // A gain map without 3D map, and an absolute gain
+    TRestDetectorGainMap absolute;
+    absolute.relative = false;
+    absolute.fChannelGain = {{3, 1.5}};
+    ASSERT_TRUE(absolute.SaveToBinary(binaryFile));
+    EXPECT_TRUE(gainMap.ReadGainBinary(binaryFile));
+    EXPECT_FALSE(gainMap.relative);
+    EXPECT_EQ(gainMap.fChannelGain, absolute.fChannelGain);
+    EXPECT_TRUE(gainMap.f2DGainMapping == nullptr);
+    EXPECT_TRUE(gainMap.f3DGainMapping == nullptr);
+
+    fs::remove(textFile);
+    fs::remove(binaryFile);
+}
+
+TEST(TRestDetectorGainMap, TruncatedFile) {
+    TRestDetectorGainMap gainMap;
+    FillGainMap(gainMap);
+
+    const auto path = fs::temp_directory_path();
+    const string textFile = (path / "gainMapTruncated.txt").string();
+    const string binaryFile = (path / "gainMapTruncated.bin").string();
+    ASSERT_TRUE(gainMap.SaveToText(textFile));
+    ASSERT_TRUE(gainMap.SaveToBinary(binaryFile));
+
+    // Each file is cut in the middle of the 3D map contents
+    fs::resize_file(textFile, fs::file_size(textFile) - 40);
+    fs::resize_file(binaryFile, fs::file_size(binaryFile) - 5 * sizeof(Double_t));
+
+    // A failed read keeps the previous gains and maps
+    TRestDetectorGainMap read;
+    read.relative = false;
+    read.fChannelGain = {{7, 2.}};
+    EXPECT_FALSE(read.ReadGainText(textFile));
+    EXPECT_FALSE(read.ReadGainBinary(binaryFile));
+    EXPECT_FALSE(read.ReadGainFile(binaryFile));
+    EXPECT_FALSE(read.relative);
+    EXPECT_EQ(read.fChannelGain, (map<int, double>{{7, 2.}}));
+    EXPECT_TRUE(read.f2DGainMapping == nullptr);
+    EXPECT_TRUE(read.f3DGainMapping == nullptr);
+
+    // A binary file cut inside the channel gains
+    fs::resize_file(binaryFile, 48);
+    EXPECT_FALSE(read.ReadGainBinary(binaryFile));
+    EXPECT_EQ(read.fChannelGain, (map<int, double>{{7, 2.}}));
+
+    fs::remove(textFile);
+    fs::remove(binaryFile);
+}
@@ -0,0 +1,653 @@
+#include <Math/MinimizerOptions.h>
+#include <TMath.h>
+#include <TTree.h>
+#include <TRestDetectorSignal.h>
+#include <TRestDetectorSignalEvent.h>
+#include <gtest/gtest.h>
+
+#include <map>
+
+using namespace std;
+
+constexpr double tolerance = 1E-6;
+
+TEST(TRestDetectorSignal, GaussianConvolution) {
+    TRestDetectorSignal signal;
+    for (int i = 0; i < 60; i++) {
+        signal.NewPoint(i + 0.3, 100 * TMath::Exp(-0.5 * (i - 30) * (i - 30) / 25.));
+    }
+
+    TRestDetectorSignal convolution;
+    signal.GetSignalGaussianConvolution(&convolution, 0.0025, 5);
+
+    // Reference obtained by numerical integration of the gaussian on each unit bin
+    const double sigma = 2.5;
+    const double range = 5 * sigma;
+    map<int, double> reference;
+    for (int i = (int)(signal.GetMinTime() - range); i < signal.GetMaxTime() + range; i++) {
+        for (int j = 0; j < signal.GetNumberOfPoints(); j++) {
+            const double time = signal.GetTime(j);
+            if (TMath::Abs(i - time) > range) continue;
+
+            const int steps = 1000;
+            double integral = 0;
+            for (int k = 0; k < steps; k++) {
+                const double x = i + (k + 0.5) / steps;
+                integral += TMath::Exp(-0.5 * (x - time) * (x - time) / sigma / sigma) / steps;
+            }
+            reference[i] += signal.GetData(j) * integral / TMath::Sqrt(2. * TMath::Pi()) / sigma;
+        }
+    }
+
+    ASSERT_EQ(convolution.GetNumberOfPoints(), (int)reference.size());
+
+    int n = 0;
+    for (const auto& [time, value] : reference) {
+        EXPECT_EQ(convolution.GetTime(n), time);
+        EXPECT_NEAR(convolution.GetData(n), value, tolerance);
+        n++;
+    }
+
+    // Only the tails beyond nSigmas are lost
+    EXPECT_NEAR(convolution.GetIntegral(), signal.GetIntegral(), 1E-5 * signal.GetIntegral());
+}
+
+TEST(TRestDetectorSignal, Labels) {
+    TRestDetectorSignalEvent event;
+    for (int id = 0; id < 3; id++) {
+        TRestDetectorSignal signal;
+        signal.SetSignalID(id);
+        signal.SetSignalName("channel" + to_string(id));
+        signal.SetSignalType("tpc");
+        event.AddSignal(signal);
+    }
+
+    for (int id = 0; id < 3; id++) {
+        EXPECT_EQ(event.GetSignalById(id)->GetSignalName(), "channel" + to_string(id));
+        EXPECT_EQ(event.GetSignalById(id)->GetSignalType(), "tpc");
+    }
+
+    // The type is shared by all signals
+    EXPECT_EQ(event.InternSignalLabel("tpc"), event.InternSignalLabel("tpc"));
+    EXPECT_EQ(event.InternSignalLabel(""), -1);
+
+    EXPECT_EQ(event.GetSignalLabel(-1), "");
+    EXPECT_EQ(event.GetSignalLabel(100), "");
+
+    // A signal copied out of the event keeps its labels after the event is gone
+    TRestDetectorSignal copy;
+    {
+        TRestDetectorSignalEvent other;
+        other.AddSignal(*event.GetSignalById(1));
+        copy = *other.GetSignal(0);
+    }
+    EXPECT_EQ(copy.GetSignalName(), "channel1");
+    EXPECT_EQ(copy.GetSignalType(), "tpc");
+
+    const TRestDetectorSignal constructed(*event.GetSignalById(2));
+    event.Initialize();
+    EXPECT_EQ(constructed.GetSignalName(), "channel2");
+    EXPECT_EQ(constructed.GetSignalType(), "tpc");
+
+    // The dictionary of the new event does not contain the labels of the previous one
+    TRestDetectorSignal signal;
+    signal.SetSignalID(5);
+    signal.SetSignalType("veto");
+    event.AddSignal(signal);
+    EXPECT_EQ(event.InternSignalLabel("veto"), 0);
+    EXPECT_EQ(event.GetSignal(0)->GetSignalName(), "");
+    EXPECT_EQ(event.GetSignal(0)->GetSignalType(), "veto");
+}
+
+TEST(TRestDetectorSignal, ImplicitTimeAxis) {
+    TRestDetectorSignal signal;
+    for (int i = 0; i < 10; i++) {
+        signal.NewPoint(5 + 0.2 * i, i);
+    }
+
+    EXPECT_FALSE(signal.HasImplicitTimeAxis());
+    EXPECT_TRUE(signal.SetImplicitTimeAxis());
+    EXPECT_TRUE(signal.HasImplicitTimeAxis());
+
+    EXPECT_EQ(signal.GetNumberOfPoints(), 10);
+    EXPECT_NEAR(signal.GetTime(3), 5.6, tolerance);
+    EXPECT_NEAR(signal.GetMaxTime(), 6.8, tolerance);
+
+    // The next sample keeps the implicit time axis
+    signal.IncreaseAmplitude(7.0, 10);
+    signal.IncreaseAmplitude(5.4, 1);
+    EXPECT_TRUE(signal.HasImplicitTimeAxis());
+    EXPECT_EQ(signal.GetNumberOfPoints(), 11);
+    EXPECT_NEAR(signal.GetData(2), 3, tolerance);
+
+    // A point out of the sampling grid restores the explicit time values
+    signal.IncreaseAmplitude(100, 1);
+    EXPECT_FALSE(signal.HasImplicitTimeAxis());
+    EXPECT_EQ(signal.GetNumberOfPoints(), 12);
+    EXPECT_NEAR(signal.GetTime(10), 7.0, tolerance);
+    EXPECT_NEAR(signal.GetTime(11), 100, tolerance);
+
+    TRestDetectorSignal sparse;
+    sparse.NewPoint(0, 1);
+    sparse.NewPoint(1, 1);
+    sparse.NewPoint(3, 1);
+    EXPECT_FALSE(sparse.SetImplicitTimeAxis());
+    EXPECT_FALSE(sparse.SetImplicitTimeAxis(0.5));
+
+    // Gaps on the sampling grid are stored as segments
+    TRestDetectorSignal gapped;
+    for (int i : {0, 1, 2, 3, 9, 10, 11, 20, 21}) {
+        gapped.NewPoint(2 + 0.5 * i, i);
+    }
+    EXPECT_TRUE(gapped.SetImplicitTimeAxis(0.5));
+    EXPECT_EQ(gapped.GetNumberOfSegments(), 3);
+    EXPECT_EQ(gapped.GetNumberOfPoints(), 9);
+    EXPECT_NEAR(gapped.GetTime(3), 3.5, tolerance);
+    EXPECT_NEAR(gapped.GetTime(4), 6.5, tolerance);
+    EXPECT_NEAR(gapped.GetTime(8), 12.5, tolerance);
+    EXPECT_NEAR(gapped.GetData(5), 10, tolerance);
+
+    gapped.IncreaseAmplitude(12.5, 1);
+    gapped.IncreaseAmplitude(13, 22);
+    EXPECT_TRUE(gapped.HasImplicitTimeAxis());
+    EXPECT_NEAR(gapped.GetData(8), 22, tolerance);
+    EXPECT_NEAR(gapped.GetTime(9), 13, tolerance);
+
+    gapped.SetExplicitTimeAxis();
+    EXPECT_NEAR(gapped.GetTime(4), 6.5, tolerance);
+    EXPECT_TRUE(gapped.SetImplicitTimeAxis());
+    EXPECT_EQ(gapped.GetNumberOfSegments(), 3);
+}
+
+TEST(TRestDetectorSignal, KeepRegions) {
+    TRestDetectorSignal signal;
+    for (int i = 0; i < 100; i++) {
+        signal.NewPoint(10 + 0.5 * i, i);
+    }
+    EXPECT_TRUE(signal.SetImplicitTimeAxis());
+
+    signal.KeepRegions({{5, 9}, {8, 12}, {40, 44}, {98, 120}});
+
+    EXPECT_TRUE(signal.HasImplicitTimeAxis());
+    EXPECT_EQ(signal.GetNumberOfPoints(), 15);
+    EXPECT_EQ(signal.GetNumberOfSegments(), 3);
+    EXPECT_NEAR(signal.GetTime(0), 12.5, tolerance);
+    EXPECT_NEAR(signal.GetData(7), 12, tolerance);
+    EXPECT_NEAR(signal.GetTime(8), 30, tolerance);
+    EXPECT_NEAR(signal.GetData(12), 44, tolerance);
+    EXPECT_NEAR(signal.GetTime(13), 59, tolerance);
+    EXPECT_NEAR(signal.GetMinTime(), 12.5, tolerance);
+    EXPECT_NEAR(signal.GetMaxTime(), 59.5, tolerance);
+    EXPECT_NEAR(signal.GetIntegral(), 5 + 6 + 7 + 8 + 9 + 10 + 11 + 12 + 40 + 41 + 42 + 43 + 44 + 98 + 99,
+                tolerance);
+
+    // Samples inside and outside the kept regions
+    signal.IncreaseAmplitude(31, 1);
+    EXPECT_EQ(signal.GetNumberOfPoints(), 15);
+    EXPECT_NEAR(signal.GetData(10), 43, tolerance);
+    signal.IncreaseAmplitude(40, 1);
+    EXPECT_FALSE(signal.HasImplicitTimeAxis());
+    EXPECT_EQ(signal.GetNumberOfPoints(), 16);
+    EXPECT_NEAR(signal.GetTime(13), 59, tolerance);
+
+    // Adjacent regions give a single segment, and every kept point keeps its time
+    TRestDetectorSignal adjacent;
+    for (int i = 0; i < 100; i++) {
+        adjacent.NewPoint(10 + 0.5 * i, i);
+    }
+    EXPECT_TRUE(adjacent.SetImplicitTimeAxis());
+    adjacent.KeepRegions({{20, 24}, {25, 27}, {30, 31}, {31, 33}, {32, 35}, {60, 60}, {61, 62}});
+    const vector<int> kept = {20, 21, 22, 23, 24, 25, 26, 27, 30, 31, 32, 33, 34, 35, 60, 61, 62};
+    ASSERT_EQ(adjacent.GetNumberOfPoints(), (int)kept.size());
+    EXPECT_EQ(adjacent.GetNumberOfSegments(), 3);
+    for (size_t n = 0; n < kept.size(); n++) {
+        EXPECT_NEAR(adjacent.GetTime(n), 10 + 0.5 * kept[n], tolerance);
+        EXPECT_NEAR(adjacent.GetData(n), kept[n], tolerance);
+        EXPECT_EQ(adjacent.GetSampleIndex(n), kept[n]);
+        EXPECT_EQ(adjacent.GetTimeIndex(10 + 0.5 * kept[n]), (int)n);
+    }
+
+    // Times in the gaps, before the first and after the last segment, or out of the grid
+    for (double time : {10., 19.5, 24., 29.5, 41.5, 60., 70., 20.2}) {
+        EXPECT_EQ(adjacent.GetTimeIndex(time), -1);
+    }
+
+    // A round trip through the explicit time axis keeps the points and the segments, the grid
+    // starting now at the first kept point
+    adjacent.SetExplicitTimeAxis();
+    EXPECT_FALSE(adjacent.HasImplicitTimeAxis());
+    EXPECT_EQ(adjacent.GetTimeIndex(25), 8);
+    EXPECT_EQ(adjacent.GetTimeIndex(24), -1);
+    EXPECT_TRUE(adjacent.SetImplicitTimeAxis(0.5));
+    EXPECT_EQ(adjacent.GetNumberOfSegments(), 3);
+    ASSERT_EQ(adjacent.GetNumberOfPoints(), (int)kept.size());
+    for (size_t n = 0; n < kept.size(); n++) {
+        EXPECT_NEAR(adjacent.GetTime(n), 10 + 0.5 * kept[n], tolerance);
+        EXPECT_EQ(adjacent.GetSampleIndex(n), kept[n] - kept[0]);
+    }
+
+    // The same regions on an explicit time axis
+    TRestDetectorSignal sparse;
+    sparse.NewPoint(0, 1);
+    sparse.NewPoint(1, 2);
+    sparse.NewPoint(3, 3);
+    sparse.NewPoint(7, 4);
+    sparse.KeepRegions({{1, 2}});
+    EXPECT_EQ(sparse.GetNumberOfPoints(), 2);
+    EXPECT_NEAR(sparse.GetTime(1), 3, tolerance);
+    EXPECT_NEAR(sparse.GetData(1), 3, tolerance);
+
+    sparse.KeepRegions({});
+    EXPECT_EQ(sparse.GetNumberOfPoints(), 0);
+}
+
+TEST(TRestDetectorSignal, ADCStorage) {
+    TRestDetectorSignalEvent event;
+
+    TRestDetectorSignal digitized;
+    digitized.SetSignalID(0);
+    for (int i = 0; i < 512; i++) {
+        digitized.NewPoint(0.04 * i, 250 + (i * 37) % 4096);
+    }
+    event.AddSignal(digitized);
+
+    TRestDetectorSignal simulated;
+    simulated.SetSignalID(1);
+    for (int i = 0; i < 100; i++) {
+        simulated.NewPoint(i, 1000 * TMath::Exp(-0.5 * (i - 50) * (i - 50) / 100.));
+    }
+    event.AddSignal(simulated);
+
+    // A sparse signal, with gaps on the sampling grid
+    TRestDetectorSignal gapped;
+    gapped.SetSignalID(2);
+    for (int i = 0; i < 60; i++) {
+        gapped.NewPoint(0.04 * (i + 100 * (i / 20)), i);
+    }
+    event.AddSignal(gapped);
+
+    event.SetADCStorage(0.1);
+
+    EXPECT_TRUE(event.GetSignalById(2)->HasADCStorage());
+    EXPECT_TRUE(event.GetSignalById(2)->HasImplicitTimeAxis());
+    EXPECT_EQ(event.GetSignalById(2)->GetNumberOfSegments(), 3);
+    for (int i = 0; i < gapped.GetNumberOfPoints(); i++) {
+        EXPECT_NEAR(event.GetSignalById(2)->GetData(i), gapped.GetData(i), 1E-9);
+        EXPECT_NEAR(event.GetSignalById(2)->GetTime(i), gapped.GetTime(i), tolerance);
+    }
+
+    // Digitized values are recovered exactly
+    const auto signal = event.GetSignalById(0);
+    EXPECT_TRUE(signal->HasADCStorage());
+    EXPECT_TRUE(signal->HasImplicitTimeAxis());
+    ASSERT_EQ(signal->GetNumberOfPoints(), digitized.GetNumberOfPoints());
+    for (int i = 0; i < signal->GetNumberOfPoints(); i++) {
+        EXPECT_NEAR(signal->GetData(i), digitized.GetData(i), 1E-9);
+        EXPECT_NEAR(signal->GetTime(i), digitized.GetTime(i), tolerance);
+    }
+
+    // Simulated values are quantized
+    for (int i = 0; i < simulated.GetNumberOfPoints(); i++) {
+        EXPECT_NEAR(event.GetSignalById(1)->GetData(i), simulated.GetData(i), 0.05 + 1E-9);
+    }
+
+    // Modifying the signal restores the double precision storage
+    signal->MultiplySignalBy(0.5);
+    EXPECT_FALSE(signal->HasADCStorage());
+    EXPECT_NEAR(signal->GetData(1), 0.5 * digitized.GetData(1), 1E-9);
+}
+
+TEST(TRestDetectorSignalEvent, SignalReuse) {
+    TRestDetectorSignalEvent event;
+    for (int n = 0; n < 3; n++) {
+        event.Initialize();
+        for (int id = 0; id < 4 - n; id++) {
+            for (int i = 0; i < 10; i++) {
+                event.AddChargeToSignal(id, i, n + id);
+            }
+        }
+        TRestDetectorSignal signal;
+        signal.SetSignalID(100);
+        signal.SetSignalType("veto");
+        signal.NewPoint(0, 1);
+        event.AddSignal(signal);
+
+        EXPECT_EQ(event.GetNumberOfSignals(), 5 - n);
+        for (int id = 0; id < 4 - n; id++) {
+            EXPECT_EQ(event.GetSignalById(id)->GetNumberOfPoints(), 10);
+            EXPECT_NEAR(event.GetSignalById(id)->GetIntegral(), 10 * (n + id), tolerance);
+            EXPECT_EQ(event.GetSignalById(id)->GetSignalType(), "");
+        }
+        EXPECT_EQ(event.GetSignalById(100)->GetSignalType(), "veto");
+        EXPECT_EQ(event.GetSignalById(100)->GetNumberOfPoints(), 1);
+    }
+}
+
+TEST(TRestDetectorSignalEvent, CopySignals) {
+    TRestDetectorSignalEvent input;
+    for (int id = 0; id < 4; id++) {
+        TRestDetectorSignal signal;
+        signal.SetSignalID(10 + id);
+        signal.SetSignalName("channel" + std::to_string(id));
+        signal.SetSignalType(id == 2 ? "veto" : "");
+        for (int i = 0; i < 5; i++) signal.NewPoint(i, id + i);
+        input.AddSignal(signal);
+    }
+
+    TRestDetectorSignalEvent output;
+    output.AddChargeToSignal(99, 0, 1);
+    for (int n = 0; n < 3; n++) {
+        output.CopySignals(input);
+        ASSERT_EQ(output.GetNumberOfSignals(), 4);
+        EXPECT_EQ(output.GetSignalById(99), nullptr);
+        for (int id = 0; id < 4; id++) {
+            const TRestDetectorSignal* signal = output.GetSignalById(10 + id);
+            ASSERT_TRUE(signal != nullptr);
+            EXPECT_EQ(signal->GetSignalName(), "channel" + std::to_string(id));
+            EXPECT_EQ(signal->GetSignalType(), id == 2 ? "veto" : "");
+            EXPECT_NEAR(signal->GetIntegral(), 5 * id + 10, tolerance);
+        }
+        EXPECT_NEAR(output.GetMaxValue(), 7, tolerance);
+
+        // The copies are independent of the input signals
+        output.GetSignalById(10)->MultiplySignalBy(10);
+        EXPECT_NEAR(input.GetSignalById(10)->GetIntegral(), 10, tolerance);
+        EXPECT_LE(output.GetSignalPoolSize(), 4u);
+    }
+}
+
+TEST(TRestDetectorSignalEvent, SignalPoolLimit) {
+    // Signals moved into the event do not come from the pool
+    TRestDetectorSignalEvent event;
+    for (int n = 0; n < 100; n++) {
+        event.Initialize();
+        EXPECT_LE(event.GetSignalPoolSize(), 5);
+        for (int id = 0; id < 1 + n % 5; id++) {
+            TRestDetectorSignal signal;
+            signal.SetSignalID(id);
+            signal.NewPoint(id, n);
+            event.AddSignal(std::move(signal));
+        }
+        EXPECT_NEAR(event.GetSignalById(0)->GetData(0), n, tolerance);
+    }
+    EXPECT_LE(event.GetSignalPoolSize(), 5);
+
+    // Signals read from a file are not taken from the pool either
+    TTree tree("events", "events");
+    TRestDetectorSignalEvent* written = &event;
+    tree.Branch("event", &written);
+    for (int n = 0; n < 50; n++) {
+        event.Initialize();
+        for (int id = 0; id < 1 + n % 5; id++) {
+            event.AddChargeToSignal(id, 0, n);
+        }
+        tree.Fill();
+    }
+
+    TRestDetectorSignalEvent* read = new TRestDetectorSignalEvent();
+    tree.SetBranchAddress("event", &read);
+    for (int n = 0; n < tree.GetEntries(); n++) {
+        read->Initialize();
+        tree.GetEntry(n);
+        EXPECT_EQ(read->GetNumberOfSignals(), 1 + n % 5);
+        EXPECT_LE(read->GetSignalPoolSize(), 5);
+    }
+    tree.ResetBranchAddresses();
+    delete read;
+}
+
+TEST(TRestDetectorSignal, FastPeakEstimators) {
+    TRestDetectorSignal gauss;
+    for (int i = 0; i < 100; i++) {
+        gauss.NewPoint(0.1 * i, 500 * TMath::Exp(-0.5 * (0.1 * i - 4.23) * (0.1 * i - 4.23) / 0.25));
+    }
+
+    Double_t residual = -1;
+    const auto gaussPeak = gauss.GetPeakGaussFast(&residual);
+    ASSERT_TRUE(gaussPeak);
+    EXPECT_NEAR(gaussPeak->first, 4.23, tolerance);
+    EXPECT_NEAR(gaussPeak->second, 500, tolerance);
+    EXPECT_NEAR(residual, 0, tolerance);
+
+    // Aget response function with amplitude 800, peak time 3.1 and width 0.9
+    TRestDetectorSignal aget;
+    for (int i = 0; i < 100; i++) {
+        const double arg = (0.05 * i - 3.1 + 1.1664) / 0.9;
+        const double value = 800 / 0.0440895 * TMath::Exp(-3 * arg) * arg * arg * arg * TMath::Sin(arg);
+        aget.NewPoint(0.05 * i, arg > 0 ? value : 0);
+    }
+
+    const auto agetPeak = aget.GetPeakAgetFast(&residual);
+    ASSERT_TRUE(agetPeak);
+    EXPECT_NEAR(agetPeak->first, 3.1, 1E-3);
+    EXPECT_NEAR(agetPeak->second, 800, 1E-1);
+    EXPECT_LT(residual, 1E-3);
+
+    TRestDetectorSignal flat;
+    flat.NewPoint(0, 0);
+    flat.NewPoint(1, 0);
+    EXPECT_FALSE(flat.GetPeakGaussFast());
+    EXPECT_FALSE(flat.GetPeakAgetFast());
+}
+
+TEST(TRestDetectorSignalEvent, GetPeaks) {
+    TRestDetectorSignalEvent event;
+    for (int id = 0; id < 8; id++) {
+        TRestDetectorSignal signal;
+        signal.SetSignalID(id);
+        const double time = 3 + 0.25 * id;
+        for (int i = 0; i < 100; i++) {
+            const double x = 0.1 * i - time;
+            signal.NewPoint(0.1 * i, (100 + 10 * id) * TMath::Exp(-0.5 * x * x / 0.25));
+        }
+        event.AddSignal(signal);
+    }
+
+    const auto peaks = event.GetPeaks("gaussFast");
+    ASSERT_EQ(peaks.size(), 8u);
+    for (int id = 0; id < 8; id++) {
+        ASSERT_TRUE(peaks[id]);
+        EXPECT_NEAR(peaks[id]->first, 3 + 0.25 * id, tolerance);
+        EXPECT_NEAR(peaks[id]->second, 100 + 10 * id, tolerance);
+    }
+
+    // The threaded fits give the same result as the serial ones, also with a minimizer that is not
+    // thread safe, where the fast estimators run in threads and their fallback fits serially
+    const std::string minimizer = ROOT::Math::MinimizerOptions::DefaultMinimizerType();
+    for (const std::string threadMinimizer : {minimizer, std::string("Minuit")}) {
+        ROOT::Math::MinimizerOptions::SetDefaultMinimizer(threadMinimizer.c_str());
+        for (const auto method : {TRestDetectorSignalEvent::PeakMethod::GaussFit,
+                                  TRestDetectorSignalEvent::PeakMethod::LandauFit,
+                                  TRestDetectorSignalEvent::PeakMethod::AgetFast}) {
+            const auto serial = event.GetPeaks(method, 1);
+            const auto threaded = event.GetPeaks(method, 4);
+            ASSERT_EQ(threaded.size(), serial.size());
+            for (size_t n = 0; n < serial.size(); n++) {
+                ASSERT_EQ(threaded[n].has_value(), serial[n].has_value());
+                if (serial[n]) {
+                    EXPECT_NEAR(threaded[n]->first, serial[n]->first, tolerance);
+                    EXPECT_NEAR(threaded[n]->second, serial[n]->second, tolerance);
+                }
+            }
+        }
+    }
+    ROOT::Math::MinimizerOptions::SetDefaultMinimizer(minimizer.c_str());
+
+    // Only the selected signals are fitted
+    const std::vector<Int_t> selection = {6, 1, 4};
+    for (const Int_t nThreads : {1, 4}) {
+        const auto selected =
+            event.GetPeaks(TRestDetectorSignalEvent::PeakMethod::GaussFast, nThreads, 0.1, &selection);
+        ASSERT_EQ(selected.size(), 8u);
+        for (int id = 0; id < 8; id++) {
+            const bool isSelected = id == 1 || id == 4 || id == 6;
+            ASSERT_EQ(selected[id].has_value(), isSelected);
+            if (isSelected) {
+                EXPECT_NEAR(selected[id]->first, 3 + 0.25 * id, tolerance);
+            }
+        }
+    }
+
+    EXPECT_EQ(TRestDetectorSignalEvent::ResolvePeakMethod("agetFit"),
+              TRestDetectorSignalEvent::PeakMethod::AgetFit);
+    EXPECT_THROW(event.GetPeaks("unknown"), std::runtime_error);
+}
+
+TEST(TRestDetectorSignal, Statistics) {
+    TRestDetectorSignal signal;
+    for (int i = 0; i < 200; i++) {
+        signal.NewPoint(1 + 0.5 * i, 100 + 10 * TMath::Sin(i) - (i == 150 ? 50 : 0) + (i == 120 ? 300 : 0));
+    }
+
+    const auto statistics = signal.ComputeStatistics(10, 60);
+    EXPECT_NEAR(statistics.maxValue, signal.GetMaxPeakValue(), tolerance);
+    EXPECT_NEAR(statistics.minValue, signal.GetMinPeakValue(), tolerance);
+    EXPECT_EQ(statistics.maxIndex, signal.GetMaxIndex());
+    EXPECT_EQ(statistics.maxIndex, 120);
+    EXPECT_EQ(statistics.minIndex, 150);
+    EXPECT_NEAR(statistics.integral, signal.GetIntegral(), tolerance);
+    EXPECT_NEAR(statistics.baseLine, signal.GetBaseLine(10, 60), tolerance);
+    EXPECT_NEAR(statistics.baseLineSigma, signal.GetBaseLineSigma(10, 60), tolerance);
+    EXPECT_NEAR(statistics.minTime, signal.GetMinTime(), tolerance);
+    EXPECT_NEAR(statistics.maxTime, signal.GetMaxTime(), tolerance);
+}
+
+TEST(TRestDetectorSignalEvent, CachedExtrema) {
+    TRestDetectorSignalEvent event;
+    event.AddChargeToSignal(1, 2, 10);
+    event.AddChargeToSignal(1, 3, 20);
+    event.AddChargeToSignal(2, 5, 5);
+
+    EXPECT_NEAR(event.GetMinTime(), 2, tolerance);
+    EXPECT_NEAR(event.GetMaxTime(), 5, tolerance);
+    EXPECT_NEAR(event.GetMaxValue(), 20, tolerance);
+
+    // Modifications through the signal pointer are taken into account
+    event.GetSignalById(2)->IncreaseAmplitude(5, 30);
+    EXPECT_NEAR(event.GetMaxValue(), 35, tolerance);
+
+    // Also through a pointer kept across extrema queries
+    TRestDetectorSignal* signal = event.GetSignal(0);
+    EXPECT_NEAR(event.GetMaxValue(), 35, tolerance);
+    signal->IncreaseAmplitude(3, 30);
+    EXPECT_NEAR(event.GetMaxValue(), 50, tolerance);
+    signal->NewPoint(1, 0.5);
+    EXPECT_NEAR(event.GetMinTime(), 1, tolerance);
+    EXPECT_NEAR(event.GetMinValue(), 0.5, tolerance);
+    signal->MultiplySignalBy(0.5);
+    EXPECT_NEAR(event.GetMaxValue(), 35, tolerance);
+    EXPECT_NEAR(event.GetMinValue(), 0.25, tolerance);
+    signal->AddOffset(-0.25);
+    EXPECT_NEAR(event.GetMinValue(), 0, tolerance);
+    signal->SetPoint(3, 60);
+    EXPECT_NEAR(event.GetMaxValue(), 60, tolerance);
+    signal->Reset();
+    signal->NewPoint(3, 10);
+    signal->NewPoint(2, 20);
+    EXPECT_NEAR(event.GetMinTime(), 2, tolerance);
+    EXPECT_NEAR(event.GetMaxValue(), 35, tolerance);
+
+    // A copy taken out of the event does not modify it
+    TRestDetectorSignal copy = *event.GetSignal(0);
+    EXPECT_NEAR(event.GetMaxValue(), 35, tolerance);
+    copy.IncreaseAmplitude(3, 100);
+    EXPECT_NEAR(event.GetMaxValue(), 35, tolerance);
+
+    event.AddChargeToSignal(3, 8, 1);
+    EXPECT_NEAR(event.GetMaxTime(), 8, tolerance);
+    EXPECT_NEAR(event.GetMinValue(), 1, tolerance);
+
+    // Read-only access
+    const TRestDetectorSignalEvent& constEvent = event;
+    EXPECT_NEAR(constEvent.GetSignal(0)->GetData(1), 20, tolerance);
+    EXPECT_NEAR(event.GetMaxValue(), 35, tolerance);
+
+    // A new event with the same ids and number of points
+    const Int_t id = event.GetID();
+    event.Initialize();
+    event.SetID(id);
+    event.AddChargeToSignal(1, 12, 100);
+    event.AddChargeToSignal(1, 13, 200);
+    event.AddChargeToSignal(2, 15, 50);
+    event.AddChargeToSignal(2, 16, 1);
+    event.AddChargeToSignal(3, 18, 10);
+    EXPECT_NEAR(event.GetMinTime(), 12, tolerance);
+    EXPECT_NEAR(event.GetMaxValue(), 200, tolerance);
+}
+
+TEST(TRestDetectorSignal, WindowAverages) {
+    // Reference implementation grouping the points of each window through a map
+    auto mapAverages = [](const TRestDetectorSignal& signal, double window) {
+        map<int, pair<int, double>> windowMap;
+        for (int j = 0; j < signal.GetNumberOfPoints(); j++) {
+            auto it = windowMap.find(signal.GetTime(j) / window);
+            if (it != windowMap.end()) {
+                it->second.first++;
+                it->second.second += signal.GetData(j);
+            } else {
+                windowMap[signal.GetTime(j) / window] = make_pair(1, signal.GetData(j));
+            }
+        }
+        vector<pair<Int_t, Double_t>> averages;
+        for (const auto& [index, entry] : windowMap) averages.emplace_back(index, entry.second / entry.first);
+        return averages;
+    };
+
+    TRestDetectorSignal signal;
+    for (int i = 0; i < 300; i++) {
+        signal.NewPoint(0.1 * i, 100 + 50 * TMath::Sin(0.1 * i));
+    }
+
+    vector<pair<Int_t, Double_t>> averages;
+    signal.GetWindowAverages(5, averages);
+    vector<pair<Int_t, Double_t>> reference = mapAverages(signal, 5);
+
+    ASSERT_EQ(averages.size(), reference.size());
+    for (size_t n = 0; n < averages.size(); n++) {
+        EXPECT_EQ(averages[n].first, reference[n].first);
+        EXPECT_NEAR(averages[n].second, reference[n].second, tolerance);
+    }
+
+    // Unsorted signals give the same windows
+    TRestDetectorSignal unsorted;
+    unsorted.NewPoint(12, 4);
+    unsorted.NewPoint(1, 2);
+    unsorted.NewPoint(11, 8);
+    unsorted.NewPoint(3, 6);
+    unsorted.GetWindowAverages(5, averages);
+    reference = mapAverages(unsorted, 5);
+    ASSERT_EQ(averages.size(), 2);
+    EXPECT_EQ(averages, reference);
+}
+
+TEST(TRestDetectorSignal, Pulses) {
+    TRestDetectorSignal signal;
+    for (int i = 0; i < 100; i++) {
+        Double_t value = 0;
+        value += 100 * TMath::Exp(-0.5 * (i - 20) * (i - 20) / 4.);
+        value += 50 * TMath::Exp(-0.5 * (i - 60) * (i - 60) / 4.);
+        value += 60 * TMath::Exp(-0.5 * (i - 70) * (i - 70) / 4.);
+        // A narrow spike
+        value += (i == 90) ? 30 : 0;
+        signal.NewPoint(i, value);
+    }
+
+    std::vector<TRestDetectorSignal::Pulse> pulses;
+    signal.GetPulses(10, pulses);
+    ASSERT_EQ(pulses.size(), 4);
+    EXPECT_EQ(pulses[0].maxIndex, 20);
+    EXPECT_NEAR(pulses[0].maxValue, 100, tolerance);
+    EXPECT_NEAR(pulses[0].time, 20, tolerance);
+    EXPECT_NEAR(pulses[0].integral, signal.GetIntegral(pulses[0].firstIndex, pulses[0].lastIndex + 1),
+                tolerance);
+    EXPECT_EQ(pulses[2].maxIndex, 70);
+
+    // The spike is removed by the width, and the close pulses are merged
+    signal.GetPulses(10, pulses, 3, 15);
+    ASSERT_EQ(pulses.size(), 2);
+    EXPECT_EQ(pulses[1].firstIndex, 57);
+    EXPECT_EQ(pulses[1].lastIndex, 73);
+    EXPECT_EQ(pulses[1].maxIndex, 70);
+    EXPECT_GT(pulses[1].time, 60);
+    EXPECT_LT(pulses[1].time, 70);
+}